@@ -0,0 +1,114 @@
+#pragma once
+
+#include <khepri/renderer/renderer.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace openglyph::benchmarks {
+
+/**
+ * @brief Renderer that creates no GPU resources and draws nothing.
+ *
+ * It counts the resources that are created and records the submitted mesh instances, so that the
+ * CPU side of rendering can be measured and inspected without a GPU.
+ */
+class NullRenderer final : public khepri::renderer::Renderer
+{
+public:
+    /// Counts of the calls into the renderer
+    struct Counters
+    {
+        std::size_t shaders{0};
+        std::size_t materials{0};
+        std::size_t textures{0};
+        std::size_t meshes{0};
+
+        /// Number of render_meshes() calls
+        std::size_t render_calls{0};
+
+        /// Total number of mesh instances submitted with render_meshes()
+        std::size_t instances{0};
+    };
+
+    std::unique_ptr<khepri::renderer::Shader>
+    create_shader(const std::filesystem::path& /*path*/,
+                  const ShaderDescLoader& /*loader*/) override
+    {
+        ++m_counters.shaders;
+        return std::make_unique<NullShader>();
+    }
+
+    std::unique_ptr<khepri::renderer::Material>
+    create_material(const khepri::renderer::MaterialDesc& /*desc*/) override
+    {
+        ++m_counters.materials;
+        return std::make_unique<NullMaterial>();
+    }
+
+    std::unique_ptr<khepri::renderer::Texture>
+    create_texture(const khepri::renderer::TextureDesc& /*desc*/) override
+    {
+        ++m_counters.textures;
+        return std::make_unique<NullTexture>();
+    }
+
+    std::unique_ptr<khepri::renderer::Mesh>
+    create_mesh(const khepri::renderer::MeshDesc& /*desc*/) override
+    {
+        ++m_counters.meshes;
+        return std::make_unique<NullMesh>();
+    }
+
+    void render_meshes(gsl::span<const khepri::renderer::MeshInstance> meshes,
+                       const khepri::renderer::Camera& /*camera*/) override
+    {
+        ++m_counters.render_calls;
+        m_counters.instances += meshes.size();
+        if (m_record) {
+            m_recorded.assign(meshes.begin(), meshes.end());
+        }
+    }
+
+    [[nodiscard]] const Counters& counters() const noexcept
+    {
+        return m_counters;
+    }
+
+    void reset_counters() noexcept
+    {
+        m_counters = {};
+    }
+
+    /// Enables recording the instances of the last render_meshes() call
+    void record(bool enabled) noexcept
+    {
+        m_record = enabled;
+    }
+
+    /// Returns the instances of the last render_meshes() call, if recording is enabled
+    [[nodiscard]] const std::vector<khepri::renderer::MeshInstance>& recorded() const noexcept
+    {
+        return m_recorded;
+    }
+
+private:
+    class NullShader final : public khepri::renderer::Shader
+    {};
+
+    class NullMaterial final : public khepri::renderer::Material
+    {};
+
+    class NullTexture final : public khepri::renderer::Texture
+    {};
+
+    class NullMesh final : public khepri::renderer::Mesh
+    {};
+
+    Counters                                    m_counters;
+    bool                                        m_record{false};
+    std::vector<khepri::renderer::MeshInstance> m_recorded;
+};
+
+} // namespace openglyph::benchmarks
@@ -0,0 +1,280 @@
+#include "null_renderer.hpp"
+
+#include <khepri/renderer/camera.hpp>
+#include <khepri/scene/scene_object.hpp>
+#include <openglyph/assets/asset_cache.hpp>
+#include <openglyph/assets/asset_loader.hpp>
+#include <openglyph/game/behaviors/render_behavior.hpp>
+#include <openglyph/game/game_object_type_store.hpp>
+#include <openglyph/game/scene.hpp>
+#include <openglyph/game/scene_renderer.hpp>
+#include <openglyph/renderer/model_creator.hpp>
+#include <openglyph/utility/thread_pool.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+// Count all allocations, to report allocations per frame
+namespace {
+std::atomic<std::size_t> g_allocations{0};
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    ++g_allocations;
+    if (void* ptr = std::malloc(size > 0 ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept
+{
+    std::free(ptr);
+}
+
+namespace {
+
+using openglyph::benchmarks::NullRenderer;
+using openglyph::renderer::Model;
+using openglyph::renderer::RenderModel;
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t NUM_MODELS = 32;
+
+// Average distance between objects
+constexpr double OBJECT_SPACING = 40.0;
+
+// Fraction of objects that move every frame
+constexpr double MOVING_FRACTION = 0.05;
+
+constexpr std::size_t WARMUP_FRAMES = 5;
+
+// Vertical field of view of the camera, in radians
+constexpr double FIELD_OF_VIEW = 1.0471975511965976;
+
+double milliseconds(Clock::duration duration)
+{
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+// Creates a mesh with a single box-shaped material
+Model::Mesh create_box_mesh(const std::string& name, unsigned int lod, float size)
+{
+    Model::Mesh mesh;
+    mesh.name         = openglyph::Symbol(name);
+    mesh.lod          = lod;
+    mesh.alt          = 0;
+    mesh.visible      = true;
+    mesh.bounding_box = {{-size, -size, -size}, {size, size, size}};
+
+    Model::Material material;
+    material.name = openglyph::Symbol("BENCHMARK");
+    for (unsigned int i = 0; i < 8; ++i) {
+        Model::Vertex vertex{};
+        vertex.position = {(i & 1) != 0 ? size : -size, (i & 2) != 0 ? size : -size,
+                           (i & 4) != 0 ? size : -size};
+        material.vertices.push_back(vertex);
+    }
+    material.indices = {0, 2, 1, 1, 2, 3, 4, 5, 6, 5, 7, 6, 0, 1, 4, 1, 5, 4,
+                        2, 6, 3, 3, 6, 7, 0, 4, 2, 2, 4, 6, 1, 3, 5, 3, 7, 5};
+    mesh.materials.push_back(std::move(material));
+    return mesh;
+}
+
+// Creates models with a hull with two LoD variants and a few detail meshes. Every eighth model is
+// large, like a capital ship or station.
+std::vector<std::unique_ptr<RenderModel>> create_models(openglyph::renderer::ModelCreator& creator)
+{
+    std::vector<std::unique_ptr<RenderModel>> models;
+    for (std::size_t i = 0; i < NUM_MODELS; ++i) {
+        const float size = (i % 8 == 0) ? 60.0f : 5.0f;
+
+        Model model;
+        model.meshes.push_back(create_box_mesh("HULL", 0, size));
+        model.meshes.push_back(create_box_mesh("HULL", 1, size));
+        for (int j = 0; j < 3; ++j) {
+            model.meshes.push_back(create_box_mesh("DETAIL_" + std::to_string(j), 0, size / 4));
+        }
+        models.push_back(creator.create_model(model));
+    }
+    return models;
+}
+
+struct Config
+{
+    const char* name;
+    bool        frustum_culling;
+    bool        occlusion_culling;
+    bool        instanced;
+    bool        threads;
+};
+
+constexpr Config CONFIGS[] = {
+    {"no culling", false, false, false, false},
+    {"frustum", true, false, false, false},
+    {"frustum+occlusion", true, true, false, false},
+    {"frustum+instanced", true, false, true, false},
+    {"frustum+threads", true, false, false, true},
+};
+
+void run(std::size_t num_objects, std::size_t num_frames)
+{
+    // Without data paths, the scene has no game object types and loads no assets
+    NullRenderer                   renderer;
+    openglyph::AssetLoader         asset_loader({});
+    openglyph::AssetCache          asset_cache(asset_loader, renderer);
+    openglyph::GameObjectTypeStore game_object_types(asset_loader, "GameObjectFiles");
+
+    const auto                        material = renderer.create_material({});
+    openglyph::renderer::ModelCreator model_creator(
+        renderer, [&](openglyph::Symbol) { return material.get(); },
+        [](std::string_view) -> khepri::renderer::Texture* { return nullptr; });
+    const auto models = create_models(model_creator);
+
+    // Scatter the objects in a cube
+    std::mt19937                           rng(42);
+    const double                           extent = OBJECT_SPACING * std::cbrt(num_objects) / 2;
+    std::uniform_real_distribution<double> coordinate(-extent, extent);
+    std::uniform_real_distribution<double> step(-1.0, 1.0);
+
+    const auto allocations_before = g_allocations.load();
+    const auto construction_start = Clock::now();
+    openglyph::Scene scene(asset_cache, game_object_types, {});
+    std::vector<std::shared_ptr<khepri::scene::SceneObject>> objects;
+    objects.reserve(num_objects);
+    for (std::size_t i = 0; i < num_objects; ++i) {
+        auto object = std::make_shared<khepri::scene::SceneObject>();
+        object->create_behavior<openglyph::RenderBehavior>(*models[i % models.size()]);
+        object->position({coordinate(rng), coordinate(rng), coordinate(rng)});
+        scene.add_object(object);
+        objects.push_back(std::move(object));
+    }
+    std::printf("%8zu objects: scene construction %.2f ms, %zu allocations\n", num_objects,
+                milliseconds(Clock::now() - construction_start),
+                g_allocations.load() - allocations_before);
+
+    khepri::renderer::Camera::Properties camera_properties;
+    camera_properties.type   = khepri::renderer::Camera::Type::perspective;
+    camera_properties.up     = {0, 0, 1};
+    camera_properties.target = {0, 0, 0};
+    camera_properties.fov    = static_cast<float>(FIELD_OF_VIEW);
+    camera_properties.aspect = 16.0f / 9.0f;
+    camera_properties.znear  = 1.0f;
+    camera_properties.zfar   = static_cast<float>(extent * 8);
+
+    openglyph::ThreadPool thread_pool;
+    for (const auto& config : CONFIGS) {
+        openglyph::SceneRenderer scene_renderer(renderer);
+        scene_renderer.frustum_culling(config.frustum_culling);
+        if (config.occlusion_culling) {
+            scene_renderer.occlusion_culling(openglyph::renderer::OcclusionSettings{});
+        }
+        if (config.threads) {
+            scene_renderer.thread_pool(&thread_pool);
+        }
+
+        std::size_t draws             = 0;
+        std::size_t batched_instances = 0;
+        if (config.instanced) {
+            scene_renderer.instanced_renderer(
+                [&](gsl::span<const openglyph::renderer::InstanceBatch> batches,
+                    const khepri::renderer::Camera& /*camera*/) {
+                    draws += batches.size();
+                    for (const auto& batch : batches) {
+                        batched_instances += batch.transforms.size();
+                    }
+                });
+        }
+
+        Clock::duration total_time{};
+        std::size_t     total_allocations = 0;
+        for (std::size_t frame = 0; frame < WARMUP_FRAMES + num_frames; ++frame) {
+            if (frame == WARMUP_FRAMES) {
+                renderer.reset_counters();
+                draws             = 0;
+                batched_instances = 0;
+            }
+
+            // Orbit the camera around the center of the objects
+            const double angle         = 0.01 * static_cast<double>(frame);
+            camera_properties.position = {std::cos(angle) * extent * 1.5,
+                                          std::sin(angle) * extent * 1.5, extent * 0.5};
+            const khepri::renderer::Camera camera(camera_properties);
+
+            const auto allocations = g_allocations.load();
+            const auto start       = Clock::now();
+
+            // Move some objects, then render
+            const auto num_moving = static_cast<std::size_t>(num_objects * MOVING_FRACTION);
+            for (std::size_t i = 0; i < num_moving; ++i) {
+                const auto& object   = objects[(frame * num_moving + i) % objects.size()];
+                auto        position = object->position();
+                position.x += step(rng);
+                position.y += step(rng);
+                object->position(position);
+                scene.update_object(object);
+            }
+            scene_renderer.render_scene(scene, camera);
+
+            if (frame >= WARMUP_FRAMES) {
+                total_time += Clock::now() - start;
+                total_allocations += g_allocations.load() - allocations;
+            }
+        }
+
+        const auto& counters  = renderer.counters();
+        const auto  frames    = static_cast<double>(num_frames);
+        const auto  instances = config.instanced ? batched_instances : counters.instances;
+        if (!config.instanced) {
+            // Every instance is a separate draw
+            draws = counters.instances;
+        }
+        std::printf("%8zu objects: %-20s %8.3f ms/frame %10.1f allocs/frame %10.1f "
+                    "instances/frame %10.1f draws/frame\n",
+                    num_objects, config.name, milliseconds(total_time) / frames,
+                    static_cast<double>(total_allocations) / frames,
+                    static_cast<double>(instances) / frames, static_cast<double>(draws) / frames);
+    }
+}
+
+} // namespace
+
+/**
+ * Renders synthetic scenes with a renderer that does not draw, and reports the CPU time,
+ * allocations, submitted instances and draws per frame for increasing numbers of objects.
+ *
+ * Usage: openglyph_benchmark [frames [object counts...]]
+ */
+int main(int argc, char* argv[])
+{
+    std::size_t              num_frames = 50;
+    std::vector<std::size_t> object_counts{1000, 5000, 20000, 50000};
+    if (argc > 1) {
+        num_frames = std::strtoul(argv[1], nullptr, 10);
+    }
+    if (argc > 2) {
+        object_counts.clear();
+        for (int i = 2; i < argc; ++i) {
+            object_counts.push_back(std::strtoul(argv[i], nullptr, 10));
+        }
+    }
+
+    for (const auto num_objects : object_counts) {
+        run(num_objects, num_frames);
+    }
+    return 0;
+}
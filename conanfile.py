@@ -32,8 +32,8 @@ class OpenGlyphConan(ConanFile):
             pass
 
     settings = "os", "compiler", "build_type", "arch"
-    options = {"shared": [True, False], "fPIC": [True, False]}
-    default_options = {"shared": False, "fPIC": True}
+    options = {"shared": [True, False], "fPIC": [True, False], "render_statistics": [True, False]}
+    default_options = {"shared": False, "fPIC": True, "render_statistics": False}
 
     generators = "CMakeDeps"
 
@@ -43,7 +43,10 @@ class OpenGlyphConan(ConanFile):
         self.requires("rapidxml/1.13", transitive_headers=True)
         # Private dependencies
 
-    exports_sources = "CMakeLists.txt", "include/*", "src/*"
+    def build_requirements(self):
+        self.test_requires("gtest/1.15.0")
+
+    exports_sources = "CMakeLists.txt", "include/*", "src/*", "tests/*"
 
     def layout(self):
         cmake_layout(self)
@@ -58,12 +61,15 @@ class OpenGlyphConan(ConanFile):
             tc.variables['OPENGLYPH_VERSION_PATCH'] = version_info['patch']
             tc.variables['OPENGLYPH_VERSION_COMMIT'] = version_info['commit']
             tc.variables['OPENGLYPH_VERSION_CLEAN'] = str(version_info['clean']).lower()
+        tc.variables['OPENGLYPH_RENDER_STATISTICS'] = bool(self.options.render_statistics)
         tc.generate()
 
     def build(self):
         cmake = CMake(self)
         cmake.configure()
         cmake.build()
+        if not self.conf.get("tools.build:skip_test", default=False):
+            cmake.test()
 
     def package(self):
         cmake = CMake(self)
@@ -71,6 +77,9 @@ class OpenGlyphConan(ConanFile):
 
     def package_info(self):
         self.cpp_info.libs = ["OpenGlyph"]
+        # Consumers need the define for RENDER_STATISTICS_ENABLED to match the library
+        if self.options.render_statistics:
+            self.cpp_info.defines.append("OPENGLYPH_RENDER_STATISTICS")
 
     @staticmethod
     def _parse_version(version):
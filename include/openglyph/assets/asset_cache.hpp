@@ -1,11 +1,20 @@
 #pragma once
 
 #include "asset_loader.hpp"
+#include "shader_source_cache.hpp"
 
 #include <khepri/renderer/renderer.hpp>
 #include <khepri/utility/cache.hpp>
 #include <openglyph/renderer/material_store.hpp>
 #include <openglyph/renderer/model_creator.hpp>
+#include <openglyph/renderer/model_streamer.hpp>
+#include <openglyph/renderer/texture_streamer.hpp>
+#include <openglyph/utility/concurrent_cache.hpp>
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <vector>
 
 namespace openglyph {
 
@@ -20,8 +29,73 @@ namespace openglyph {
 class AssetCache final
 {
 public:
+    /// Settings of the asset cache
+    struct Options
+    {
+        /**
+         * @brief Path of the manifest of resolved shader sources.
+         *
+         * If set, the manifest is loaded on construction, before any shader is created, and
+         * saved on destruction. See ShaderSourceCache::unchanged().
+         */
+        std::optional<std::filesystem::path> shader_manifest;
+
+        /**
+         * @brief Settings for streaming the textures of render models.
+         *
+         * If set, model textures are created with only their smallest mip levels; higher mip
+         * levels are streamed in by the cache's #texture_streamer(). Textures requested via
+         * #get_texture() and the default textures of materials are always loaded fully.
+         */
+        std::optional<openglyph::renderer::TextureStreamer::Options> texture_streaming;
+
+        /**
+         * @brief When and how to instantiate the materials from the material catalog.
+         *
+         * @note MaterialStore::Mode::parallel creates shaders and textures from multiple threads
+         * and requires a renderer that supports concurrent resource creation.
+         */
+        openglyph::renderer::MaterialStore::Mode material_mode{
+            openglyph::renderer::MaterialStore::Mode::immediate};
+
+        /**
+         * @brief Thread pool to load the shaders and textures of materials on.
+         *
+         * See openglyph::renderer::MaterialStore::thread_pool(). Only used with
+         * MaterialStore::Mode::parallel; if null, they're loaded on the calling thread.
+         */
+        ThreadPool* material_thread_pool{nullptr};
+
+        /**
+         * @brief Settings for streaming the LoD variants of render models.
+         *
+         * If set, render models are created with only their least detailed LoD variants; more
+         * detailed variants are streamed in by the cache's #model_streamer().
+         */
+        std::optional<openglyph::renderer::ModelStreamer::Options> model_streaming;
+
+        /**
+         * @brief Thread pool to convert the meshes of render models on.
+         *
+         * See openglyph::renderer::ModelCreator::thread_pool(). If null, meshes are converted on
+         * the thread that requests the model. Streamed LoD variants are also decoded on this pool
+         * (see openglyph::renderer::ModelStreamer).
+         */
+        ThreadPool* model_thread_pool{nullptr};
+
+        /**
+         * @brief Whether render models share identical meshes.
+         *
+         * See openglyph::renderer::ModelCreator::deduplicate_meshes().
+         */
+        bool deduplicate_meshes{false};
+    };
+
     AssetCache(AssetLoader& asset_loader, khepri::renderer::Renderer& renderer);
 
+    AssetCache(AssetLoader& asset_loader, khepri::renderer::Renderer& renderer,
+               const Options& options);
+
     AssetCache(const AssetCache&) = delete;
     AssetCache& operator=(const AssetCache&) = delete;
     ~AssetCache();
@@ -32,11 +106,59 @@ public:
 
     openglyph::renderer::RenderModel* get_render_model(std::string_view name);
 
+    /**
+     * @brief Returns the cache of shader source files.
+     *
+     * Use this to check which shaders are unchanged since the run that saved the manifest in
+     * Options::shader_manifest.
+     */
+    ShaderSourceCache& shader_sources() noexcept
+    {
+        return m_shader_sources;
+    }
+
+    /**
+     * @brief Returns the streamer of model textures.
+     *
+     * Returns nullptr if the cache was constructed without texture streaming.
+     */
+    openglyph::renderer::TextureStreamer* texture_streamer() noexcept
+    {
+        return m_texture_streamer.get();
+    }
+
+    /**
+     * @brief Returns the creator of render models.
+     *
+     * Use this to query how many meshes were deduplicated.
+     */
+    const openglyph::renderer::ModelCreator& model_creator() const noexcept
+    {
+        return m_model_creator;
+    }
+
+    /**
+     * @brief Returns the streamer of render models.
+     *
+     * Returns nullptr if the cache was constructed without model streaming.
+     */
+    openglyph::renderer::ModelStreamer* model_streamer() noexcept
+    {
+        return m_model_streamer.get();
+    }
+
 private:
-    khepri::OwningCache<khepri::renderer::Shader>         m_shader_cache;
-    khepri::OwningCache<khepri::renderer::Texture>        m_texture_cache;
+    std::optional<std::filesystem::path> m_shader_manifest;
+
+    ShaderSourceCache                                     m_shader_sources;
+    ConcurrentCache<khepri::renderer::Shader>             m_shader_cache;
+    ConcurrentCache<khepri::renderer::Texture>            m_texture_cache;
+    std::unique_ptr<openglyph::renderer::TextureStreamer> m_texture_streamer;
+    std::vector<const khepri::renderer::Texture*>         m_streamed_textures;
+    khepri::OwningCache<khepri::renderer::Texture>        m_streamed_texture_cache;
     openglyph::renderer::MaterialStore                    m_materials;
     openglyph::renderer::ModelCreator                     m_model_creator;
+    std::unique_ptr<openglyph::renderer::ModelStreamer>   m_model_streamer;
     khepri::OwningCache<openglyph::renderer::RenderModel> m_render_model_cache;
 };
 
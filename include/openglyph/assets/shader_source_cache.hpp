@@ -0,0 +1,114 @@
+#pragma once
+
+#include "asset_loader.hpp"
+
+#include <khepri/renderer/renderer.hpp>
+#include <khepri/renderer/shader_desc.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace openglyph {
+
+/**
+ * @brief Cache of parsed shader source files.
+ *
+ * Shader files, including shared include files, are opened and parsed once and handed out from
+ * memory on subsequent requests. Files are identified by their normalized path, so "Foo.fxh",
+ * "FOO.FXH" and "./foo.fxh" refer to the same file.
+ *
+ * For every shader created through #create_shader(), the cache also records a hash of the fully
+ * resolved source: the hashes of the shader file and of all files it included, in the order the
+ * renderer requested them. These are persisted in a manifest with #save_manifest(). On startup,
+ * #load_manifest() re-hashes the files that each shader in the manifest resolved to, without
+ * parsing them, and #unchanged() then reports which shaders are identical to the previous run
+ * before they are created. khepri::renderer::Renderer always compiles shaders from source, so
+ * reusing compiled shaders of unchanged shaders is left to renderers that keep them.
+ *
+ * The cache is thread-safe: shaders can be created from multiple threads concurrently.
+ */
+class ShaderSourceCache final
+{
+public:
+    explicit ShaderSourceCache(AssetLoader& asset_loader) : m_asset_loader(asset_loader) {}
+
+    ShaderSourceCache(const ShaderSourceCache&) = delete;
+    ShaderSourceCache& operator=(const ShaderSourceCache&) = delete;
+    ~ShaderSourceCache();
+
+    /**
+     * @brief Returns a parsed shader file.
+     *
+     * The file is loaded on the first request for its normalized path.
+     *
+     * @return the parsed file, or nullptr if the file could not be opened.
+     */
+    const khepri::renderer::ShaderDesc* get(const std::filesystem::path& path);
+
+    /**
+     * @brief Creates a shader, loading the shader file and its includes from the cache.
+     */
+    std::unique_ptr<khepri::renderer::Shader> create_shader(khepri::renderer::Renderer& renderer,
+                                                            std::string_view            name);
+
+    /**
+     * @brief Returns the hash of the fully resolved source of a shader.
+     *
+     * Returns @a std::nullopt if the shader has not been created via #create_shader().
+     */
+    std::optional<std::uint64_t> resolved_hash(std::string_view name) const;
+
+    /**
+     * @brief Checks if a shader's resolved source is identical to the one in the loaded manifest.
+     *
+     * This can be checked before the shader is created.
+     */
+    bool unchanged(std::string_view name) const;
+
+    /**
+     * @brief Loads the manifest of a previous run and checks which of its shaders are unchanged.
+     *
+     * Does nothing if the manifest does not exist or cannot be read.
+     */
+    void load_manifest(const std::filesystem::path& path);
+
+    /**
+     * @brief Stores the resolved sources of all shaders created so far, and of the unchanged
+     * shaders of the loaded manifest.
+     *
+     * @throws khepri::io::Error if the manifest could not be written.
+     */
+    void save_manifest(const std::filesystem::path& path) const;
+
+private:
+    struct SourceFile
+    {
+        std::optional<khepri::renderer::ShaderDesc> desc;
+        std::uint64_t                               hash{0};
+    };
+
+    // The files that a shader resolved to, in the order the renderer requested them
+    struct ResolvedShader
+    {
+        std::uint64_t            hash{0};
+        std::vector<std::string> files;
+    };
+
+    const SourceFile& load(const std::filesystem::path& path);
+
+    AssetLoader&       m_asset_loader;
+    mutable std::mutex m_mutex;
+
+    std::map<std::string, SourceFile>     m_files;
+    std::map<std::string, ResolvedShader> m_resolved;
+    std::map<std::string, ResolvedShader> m_unchanged;
+};
+
+} // namespace openglyph
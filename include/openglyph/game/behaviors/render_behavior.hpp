@@ -1,8 +1,14 @@
 #pragma once
 
 #include <khepri/scene/behavior.hpp>
+#include <openglyph/game/render_handle.hpp>
 #include <openglyph/renderer/render_model.hpp>
 
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
 namespace openglyph {
 
 class RenderBehavior : public khepri::scene::Behavior
@@ -13,6 +19,16 @@ public:
         std::string model_name;
     };
 
+    /// Override of a material parameter of one of the model's meshes
+    struct ParamOverride
+    {
+        /// Index of the mesh in the model
+        std::size_t mesh_index;
+
+        /// The parameter that replaces (or is added to) the mesh's parameters
+        renderer::RenderModel::Mesh::Param param;
+    };
+
     explicit RenderBehavior(const renderer::RenderModel& model) : m_model(model) {}
 
     const auto& model() const noexcept
@@ -30,9 +46,86 @@ public:
         m_scale = scale;
     }
 
+    [[nodiscard]] bool visible() const noexcept
+    {
+        return m_visible;
+    }
+
+    void visible(bool visible) noexcept
+    {
+        m_visible = visible;
+    }
+
+    /**
+     * Overrides a material parameter for this object only.
+     *
+     * Objects without overrides share the model's material parameters. Replaces an earlier
+     * override of the same parameter on the same mesh.
+     */
+    void override_param(std::size_t mesh_index, renderer::RenderModel::Mesh::Param param)
+    {
+        for (auto& param_override : m_param_overrides) {
+            if (param_override.mesh_index == mesh_index &&
+                param_override.param.name == param.name) {
+                param_override.param = std::move(param);
+                ++m_param_version;
+                return;
+            }
+        }
+        m_param_overrides.push_back({mesh_index, std::move(param)});
+        ++m_param_version;
+    }
+
+    /// Removes all material parameter overrides
+    void clear_param_overrides() noexcept
+    {
+        m_param_overrides.clear();
+        ++m_param_version;
+    }
+
+    [[nodiscard]] const auto& param_overrides() const noexcept
+    {
+        return m_param_overrides;
+    }
+
+    /// Returns a number that changes every time the parameter overrides change
+    [[nodiscard]] std::uint32_t param_version() const noexcept
+    {
+        return m_param_version;
+    }
+
+    /// Returns the handle of the object's components in the render list it was added to
+    [[nodiscard]] RenderHandle render_handle() const noexcept
+    {
+        return m_render_handle;
+    }
+
+    /// Sets the handle of the object's components; called by RenderList
+    void render_handle(RenderHandle handle) noexcept
+    {
+        m_render_handle = handle;
+    }
+
+    /// Returns the ID of the object in the spatial index of the scene it was added to
+    [[nodiscard]] std::uint32_t spatial_id() const noexcept
+    {
+        return m_spatial_id;
+    }
+
+    /// Sets the ID of the object in the scene's spatial index; called by Scene
+    void spatial_id(std::uint32_t id) noexcept
+    {
+        m_spatial_id = id;
+    }
+
 private:
     const renderer::RenderModel& m_model;
     double                       m_scale{1.0};
+    bool                         m_visible{true};
+    std::vector<ParamOverride>   m_param_overrides;
+    std::uint32_t                m_param_version{0};
+    RenderHandle                 m_render_handle;
+    std::uint32_t                m_spatial_id{std::numeric_limits<std::uint32_t>::max()};
 };
 
 } // namespace openglyph
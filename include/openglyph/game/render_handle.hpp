@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+namespace openglyph {
+
+/**
+ * @brief Stable handle of an object's render components in a RenderList.
+ *
+ * The handle stays valid while the object is in the list, even as the list moves the object's
+ * components around when other objects are added and removed. Once the object is removed, the
+ * handle no longer resolves, even if its slot is reused.
+ */
+struct RenderHandle
+{
+    /// Index of the handle's slot in the list
+    std::uint32_t index{std::numeric_limits<std::uint32_t>::max()};
+
+    /// Generation of the slot when the handle was created
+    std::uint32_t generation{0};
+
+    /// Returns true if the handle was ever assigned
+    [[nodiscard]] bool valid() const noexcept
+    {
+        return index != std::numeric_limits<std::uint32_t>::max();
+    }
+};
+
+} // namespace openglyph
@@ -0,0 +1,401 @@
+#pragma once
+
+#include <gsl/gsl-lite.hpp>
+#include <khepri/renderer/mesh_instance.hpp>
+#include <khepri/scene/scene_object.hpp>
+#include <openglyph/game/render_snapshot.hpp>
+#include <openglyph/renderer/lod_settings.hpp>
+#include <openglyph/renderer/model_streamer.hpp>
+#include <openglyph/renderer/render_model.hpp>
+#include <openglyph/renderer/texture_streamer.hpp>
+#include <openglyph/utility/thread_pool.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace openglyph {
+
+class RenderBehavior;
+
+/**
+ * @brief Retained list of the mesh instances to render for a scene.
+ *
+ * The list is maintained incrementally as objects are added to, removed from or changed in a
+ * scene, so that rendering a frame does not need to rebuild the instances of every object.
+ *
+ * The mesh instances are kept in persistent storage. Every object's world matrix is cached and
+ * only recomputed when the object changes; the changed objects' matrices are recomputed together
+ * in a single batch before the instances are next returned, and written into the instance storage
+ * in place. Adding, removing or changing the visibility of objects causes the storage to be
+ * compacted instead, which reuses its capacity. Changes are either reported with #update() or
+ * found by #detect_changes(), which compares every object's transform with the one its world
+ * matrix was computed from.
+ *
+ * Per-object render state is kept in contiguous arrays, one per component, that are processed
+ * linearly every frame. Every object's RenderBehavior holds a stable handle to its components,
+ * through which the object is found in constant time. Objects whose handle does not refer to
+ * this list, e.g. because they lost their RenderBehavior, are found through a hash map instead.
+ *
+ * Objects share their model's material parameters. Only objects that override parameters (see
+ * RenderBehavior::override_param()) get their own parameter blocks, for the overridden meshes.
+ */
+class RenderList final
+{
+public:
+    using Param = renderer::RenderModel::Mesh::Param;
+
+    RenderList();
+
+    RenderList(const RenderList&) = delete;
+    RenderList& operator=(const RenderList&) = delete;
+    ~RenderList();
+
+    /// Returns the number of objects in the list
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return m_components.size();
+    }
+
+    /// Returns the number of meshes of the objects' models, including all LoD variants
+    [[nodiscard]] std::size_t mesh_count() const noexcept
+    {
+        return m_mesh_count;
+    }
+
+    /**
+     * Adds an object to the list.
+     *
+     * Does nothing if the object has no RenderBehavior or is already added.
+     */
+    void add(khepri::scene::SceneObject& object);
+
+    /**
+     * Removes an object from the list.
+     *
+     * Does nothing if the object is not in the list.
+     */
+    void remove(const khepri::scene::SceneObject& object);
+
+    /**
+     * Updates the list after an object's transform, scale, visibility or parameter overrides
+     * changed.
+     *
+     * Adds the object if it was not added before, but has a RenderBehavior by now.
+     */
+    void update(khepri::scene::SceneObject& object);
+
+    /**
+     * Finds and updates the objects that changed without a call to #update().
+     *
+     * Compares every object's transform, RenderBehavior scale, visibility and parameter version
+     * with the ones the list last saw. This reads every object, but does not recompute any
+     * matrices for the objects that did not change. Objects that lost their RenderBehavior are
+     * removed.
+     *
+     * @return the objects that changed or were removed, valid until the next call.
+     */
+    gsl::span<const khepri::scene::SceneObject* const> detect_changes();
+
+#ifndef NDEBUG
+    /// Asserts that no object changed without a call to #update()
+    void verify_unchanged() const;
+#endif
+
+    /**
+     * Resolves the streamed textures in the material parameters of all objects.
+     *
+     * Does nothing if the streamer's generation has not changed since the last call. Models and
+     * objects that are added afterwards have their textures resolved against the same streamer.
+     */
+    void resolve_textures(const renderer::TextureStreamer& texture_streamer);
+
+    /**
+     * Picks up the meshes of streamed models that became resident.
+     *
+     * Objects draw the most detailed resident variant of their selected meshes. Does nothing if
+     * the streamer's generation has not changed since the last call.
+     */
+    void resolve_meshes(const renderer::ModelStreamer& model_streamer);
+
+    /**
+     * Restricts the list to the given objects, e.g. the objects inside the view frustum.
+     *
+     * Until the next call, #select_lods() and #sorted_instances() only process these objects, so
+     * their cost depends on the number of visible objects instead of all objects. Objects that
+     * are not in the list or have no RenderBehavior are ignored. Removing an object from the list
+     * resets the restriction.
+     */
+    void cull(gsl::span<const khepri::scene::SceneObject* const> visible_objects);
+
+    /// Removes the restriction set by #cull()
+    void reset_culling() noexcept
+    {
+        m_culled = false;
+    }
+
+    /**
+     * Requests the textures of the rendered meshes from a texture streamer.
+     *
+     * Every texture is requested with the size of its object on screen. If the list is culled,
+     * only the textures of the visible objects are requested.
+     *
+     * @param texture_streamer the streamer to request the textures from
+     * @param eye the position of the camera
+     * @param projection_scale the vertical scale factor of the camera's projection
+     */
+    void request_textures(renderer::TextureStreamer& texture_streamer, const khepri::Vector3& eye,
+                          float projection_scale) const;
+
+    /**
+     * Selects the level of detail of every object from its size on screen.
+     *
+     * For every LoD group of an object's model, only the selected variant is rendered. Objects
+     * start at full detail.
+     *
+     * @param eye the position of the camera
+     * @param projection_scale the vertical scale factor of the camera's projection
+     * @param settings the thresholds for reducing detail
+     * @param thread_pool if set, objects are processed in parallel on this pool
+     */
+    void select_lods(const khepri::Vector3& eye, float projection_scale,
+                     const renderer::LodSettings& settings, ThreadPool* thread_pool = nullptr);
+
+    /**
+     * Returns the mesh instances to render, in the order the objects were added.
+     *
+     * @param thread_pool if set, pending changes to large lists are applied in parallel on this
+     *                    pool. The result is the same as without a pool.
+     */
+    gsl::span<const khepri::renderer::MeshInstance> instances(ThreadPool* thread_pool = nullptr);
+
+    /**
+     * Returns the mesh instances to render, sorted to minimize render state changes.
+     *
+     * Opaque instances are grouped by shader, material and mesh and drawn front to back;
+     * translucent instances are drawn back to front (see renderer::SortKey).
+     *
+     * @param eye the position of the camera
+     * @param thread_pool if set, pending changes to large lists are applied and sort keys are
+     *                    computed in parallel on this pool. The result is the same as without a
+     *                    pool.
+     */
+    gsl::span<const khepri::renderer::MeshInstance>
+    sorted_instances(const khepri::Vector3& eye, ThreadPool* thread_pool = nullptr);
+
+    /**
+     * Copies the mesh instances to render into a snapshot.
+     *
+     * Pending changes are applied first. If the list is culled, only the instances of the
+     * visible objects are copied. The snapshot remains valid while the list and its objects
+     * change (see RenderSnapshot).
+     *
+     * @param snapshot the snapshot to replace the contents of
+     * @param thread_pool if set, pending changes to large lists are applied in parallel on this
+     *                    pool
+     */
+    void extract(RenderSnapshot& snapshot, ThreadPool* thread_pool = nullptr);
+
+    /**
+     * Returns the shader property slots of the material parameters of each sorted instance.
+     *
+     * The returned spans correspond to the instances returned by the last call to
+     * #sorted_instances(). A span is empty if the instance's material is not known.
+     */
+    gsl::span<const gsl::span<const std::uint32_t>> sorted_param_slots() const noexcept
+    {
+        return m_snapshot.sorted_param_slots();
+    }
+
+private:
+    struct ParamOverlay
+    {
+        std::size_t                mesh_index;
+        std::vector<Param>         params;
+        std::vector<std::uint32_t> slots;
+    };
+
+    // Bits in Components::flags
+    enum Flags : std::uint8_t
+    {
+        VISIBLE = 1,
+        DIRTY   = 2,
+    };
+
+    // Index in Components::overlays of objects without parameter overlays
+    static constexpr std::uint32_t NO_OVERLAYS = std::numeric_limits<std::uint32_t>::max();
+
+    // The render components of all objects, in structure-of-arrays form: the components of an
+    // object are at the same index in every array. Removing an object moves the last object's
+    // components into its place, so the arrays stay dense.
+    struct Components
+    {
+        std::vector<const khepri::scene::SceneObject*> objects;
+        std::vector<const renderer::RenderModel*>      models;
+        std::vector<khepri::Vector3>                   positions;
+        std::vector<double>                            scales;
+        std::vector<khepri::Matrixf>                   local_transforms;
+        std::vector<khepri::Matrixf>                   world_transforms;
+        std::vector<std::uint8_t>                      flags;
+
+        // The object's transform that its world transform was last computed from
+        std::vector<khepri::Matrixf> source_transforms;
+
+        std::vector<float>                             radii;
+        std::vector<unsigned int>                      lod_reductions;
+
+        // Index of the object's parameter overlays in m_overlays, or NO_OVERLAYS
+        std::vector<std::uint32_t> overlays;
+        std::vector<std::uint32_t> param_versions;
+
+        // Range of the object's visible meshes (one per LoD group) in the instance list
+        std::vector<std::size_t> first_instances;
+        std::vector<std::size_t> instance_counts;
+
+        // Slot of the object's handle in m_slots
+        std::vector<std::uint32_t> slots;
+
+        [[nodiscard]] std::size_t size() const noexcept
+        {
+            return objects.size();
+        }
+
+        // Calls fn for every array
+        template <typename Fn>
+        void for_each_array(const Fn& fn)
+        {
+            fn(objects);
+            fn(models);
+            fn(positions);
+            fn(scales);
+            fn(local_transforms);
+            fn(world_transforms);
+            fn(flags);
+            fn(source_transforms);
+            fn(radii);
+            fn(lod_reductions);
+            fn(overlays);
+            fn(param_versions);
+            fn(first_instances);
+            fn(instance_counts);
+            fn(slots);
+        }
+    };
+
+    // A handle slot: the index of the components it refers to, and its generation
+    struct Slot
+    {
+        std::uint32_t component;
+        std::uint32_t generation;
+    };
+
+    // The parameter blocks of the meshes for which an object overrides parameters: the model's
+    // parameters merged with the overrides. Other meshes use the shared parameters.
+    using ParamOverlays = std::vector<ParamOverlay>;
+
+    using ParamBlocks = std::vector<std::vector<Param>>;
+
+    static constexpr std::size_t NOT_FOUND = std::numeric_limits<std::size_t>::max();
+
+    // Returns the index of an object's components, or NOT_FOUND
+    std::size_t find(const khepri::scene::SceneObject& object) const noexcept;
+
+    // Registers an object's use of a model's shared parameters, or ends it. The parameters of a
+    // model are retired when its last object is removed.
+    void acquire_shared_params(const renderer::RenderModel& model);
+    void release_shared_params(const renderer::RenderModel& model);
+
+    // Creates the parameters shared by all objects without overrides for a model, if needed
+    void create_shared_params(const renderer::RenderModel& model);
+
+    // Returns the shared parameters for a model's mesh; they must have been created
+    gsl::span<const Param> shared_params(const renderer::RenderModel& model,
+                                         std::size_t                  mesh) const;
+
+    void remove_at(std::size_t index);
+    void update_at(std::size_t index, const RenderBehavior& render);
+
+    // Checks if an object changed since its components were last updated
+    [[nodiscard]] bool changed(std::size_t index, const RenderBehavior& render) const noexcept;
+
+    void        mark_dirty(std::size_t index);
+    void        update_transforms();
+    void        update_overlays(std::size_t index, const RenderBehavior& render);
+    std::size_t count_instances(std::size_t index) const noexcept;
+
+    void write_instances(std::size_t index);
+    void resize_instances(std::size_t size);
+    void append_instances(std::size_t index);
+    void rebuild(ThreadPool* thread_pool);
+
+    // Returns the number of objects to process, and the index of the i-th one
+    [[nodiscard]] std::size_t active_count() const noexcept
+    {
+        return m_culled ? m_visible.size() : m_components.size();
+    }
+    [[nodiscard]] std::size_t active(std::size_t i) const noexcept
+    {
+        return m_culled ? m_visible[i] : i;
+    }
+
+    struct SharedParams
+    {
+        std::size_t users{0}; ///< Number of objects in the list that use the model
+        ParamBlocks blocks;   ///< Resolved parameters of each mesh, if created
+    };
+
+    using ModelParams = std::unordered_map<const renderer::RenderModel*, SharedParams>;
+
+    Components                 m_components;
+    std::size_t                m_mesh_count{0};
+    std::vector<Slot>          m_slots;
+    std::vector<std::uint32_t> m_free_slots;
+
+    // The handle slot of every object, for objects whose handle does not refer to this list
+    std::unordered_map<const khepri::scene::SceneObject*, std::uint32_t> m_object_slots;
+
+    // Parameter overlays of the objects that override parameters
+    std::vector<ParamOverlays> m_overlays;
+    std::vector<std::uint32_t> m_free_overlays;
+
+    std::vector<khepri::renderer::MeshInstance> m_instances;
+
+    // Objects found by #detect_changes()
+    std::vector<const khepri::scene::SceneObject*> m_changed;
+
+    // Objects whose world transform must be recomputed, and buffers to do so in a batch
+    std::vector<std::size_t>     m_dirty;
+    std::vector<khepri::Matrixf> m_dirty_transforms;
+    std::vector<khepri::Matrixf> m_dirty_local_transforms;
+    std::vector<khepri::Matrixf> m_dirty_world_transforms;
+
+    // Depth-less sort key, position and parameter slots of every instance
+    std::vector<std::uint64_t>                  m_sort_keys;
+    std::vector<khepri::Vector3>                m_positions;
+    std::vector<gsl::span<const std::uint32_t>> m_param_slots;
+
+    // The instances to sort for #sorted_instances()
+    RenderSnapshot m_snapshot;
+
+    // Per model in use, the parameters of each mesh with streamed textures resolved. Only used
+    // with a texture streamer; otherwise objects use the model's parameters directly.
+    ModelParams m_resolved_params;
+
+    // Parameters of models that are no longer used. Instances and snapshots may still refer to
+    // them until the next rebuild, so they are only freed then.
+    std::vector<ParamBlocks> m_retired_params;
+
+    // Components of the visible objects if the list is culled
+    std::vector<std::size_t> m_visible;
+    bool                     m_culled{false};
+
+    const renderer::TextureStreamer* m_texture_streamer{nullptr};
+    std::uint64_t                    m_texture_generation{0};
+    std::uint64_t                    m_mesh_generation{0};
+    bool                             m_rebuild{false};
+};
+
+} // namespace openglyph
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <gsl/gsl-lite.hpp>
+#include <khepri/renderer/camera.hpp>
+#include <khepri/renderer/mesh_instance.hpp>
+#include <openglyph/renderer/render_model.hpp>
+#include <openglyph/utility/thread_pool.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace openglyph {
+
+/**
+ * @brief A self-contained copy of the mesh instances to render for a frame.
+ *
+ * A snapshot is extracted from a scene's RenderList at a synchronization point between the
+ * simulation and rendering (see SceneRenderer::extract()). It holds the visible mesh instances
+ * with their world transforms, sort keys and material parameters. Parameters that objects
+ * override are copied into the snapshot; all other parameters refer to their render models.
+ *
+ * Once extracted, the snapshot does not refer to the scene's objects or render list, so it can be
+ * rendered on another thread while the simulation changes the scene. Render models and the
+ * texture streamer must not change until the snapshot is rendered.
+ *
+ * Snapshots keep their storage when they are extracted again, so a pair of snapshots that are
+ * used alternately does not allocate in steady state.
+ */
+class RenderSnapshot final
+{
+public:
+    using Param = renderer::RenderModel::Mesh::Param;
+
+    RenderSnapshot();
+
+    RenderSnapshot(const RenderSnapshot&) = delete;
+    RenderSnapshot& operator=(const RenderSnapshot&) = delete;
+    ~RenderSnapshot();
+
+    /// Returns the camera the snapshot was extracted for, if any
+    [[nodiscard]] const std::optional<khepri::renderer::Camera>& camera() const noexcept
+    {
+        return m_camera;
+    }
+
+    /// Sets the camera the snapshot is rendered with
+    void camera(const khepri::renderer::Camera& camera)
+    {
+        m_camera.emplace(camera);
+    }
+
+    /// Returns the mesh instances in the snapshot, in no particular order
+    [[nodiscard]] gsl::span<const khepri::renderer::MeshInstance> instances() const noexcept
+    {
+        return m_instances;
+    }
+
+    /**
+     * Returns the mesh instances, sorted to minimize render state changes.
+     *
+     * Opaque instances are grouped by shader, material and mesh and drawn front to back;
+     * translucent instances are drawn back to front (see renderer::SortKey).
+     *
+     * @param eye the position of the camera
+     * @param thread_pool if set, sort keys are computed in parallel on this pool. The result is
+     *                    the same as without a pool.
+     */
+    gsl::span<const khepri::renderer::MeshInstance>
+    sorted_instances(const khepri::Vector3& eye, ThreadPool* thread_pool = nullptr);
+
+    /**
+     * Returns the shader property slots of the material parameters of each sorted instance.
+     *
+     * The returned spans correspond to the instances returned by the last call to
+     * #sorted_instances(). A span is empty if the instance's material is not known.
+     */
+    [[nodiscard]] gsl::span<const gsl::span<const std::uint32_t>>
+    sorted_param_slots() const noexcept
+    {
+        return m_sorted_param_slots;
+    }
+
+private:
+    friend class RenderList;
+
+    // Removes all instances, keeping the storage
+    void clear() noexcept;
+
+    // Adds an instance whose parameters outlive the snapshot
+    void add(const khepri::renderer::MeshInstance& instance, gsl::span<const std::uint32_t> slots,
+             std::uint64_t sort_key, const khepri::Vector3& position);
+
+    // Adds an instance and copies its parameters into the snapshot
+    void add_copy(const khepri::renderer::MeshInstance& instance,
+                  gsl::span<const std::uint32_t> slots, std::uint64_t sort_key,
+                  const khepri::Vector3& position);
+
+    std::optional<khepri::renderer::Camera> m_camera;
+
+    // Depth-less sort key, position and parameter slots of every instance
+    std::vector<khepri::renderer::MeshInstance> m_instances;
+    std::vector<std::uint64_t>                  m_sort_keys;
+    std::vector<khepri::Vector3>                m_positions;
+    std::vector<gsl::span<const std::uint32_t>> m_param_slots;
+
+    // Copies of overridden parameters. Blocks past m_num_copies are unused, but keep their storage.
+    std::vector<std::pair<std::vector<Param>, std::vector<std::uint32_t>>> m_copies;
+    std::size_t                                                            m_num_copies{0};
+
+    // Buffers for sorting, kept to avoid reallocation
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> m_sort_items;
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> m_sort_scratch;
+    std::vector<khepri::renderer::MeshInstance>          m_sorted_instances;
+    std::vector<gsl::span<const std::uint32_t>>          m_sorted_param_slots;
+};
+
+} // namespace openglyph
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+
+namespace openglyph {
+
+/**
+ * True if the library is built with render statistics (the OPENGLYPH_RENDER_STATISTICS CMake
+ * option, or the render_statistics Conan option). Without them, no statistics are collected and
+ * RenderStatistics stays zero.
+ */
+#ifdef OPENGLYPH_RENDER_STATISTICS
+inline constexpr bool RENDER_STATISTICS_ENABLED = true;
+#else
+inline constexpr bool RENDER_STATISTICS_ENABLED = false;
+#endif
+
+/**
+ * @brief Statistics of a single frame rendered by a SceneRenderer.
+ */
+struct RenderStatistics
+{
+    /// Number of objects with a RenderBehavior that were processed, i.e. that are not outside the
+    /// view frustum
+    std::size_t objects_visited{0};
+
+    /// Number of processed objects that were hidden behind occluders
+    std::size_t objects_occluded{0};
+
+    /// Number of meshes of the objects that were not culled, including all LoD variants
+    std::size_t meshes_considered{0};
+
+    /// Number of considered meshes that were not rendered: invisible meshes, meshes of invisible
+    /// objects and LoD variants that were not selected
+    std::size_t meshes_rejected{0};
+
+    /// Number of meshes of the objects that were culled
+    std::size_t meshes_culled{0};
+
+    /// Number of mesh instances that were submitted to the renderer
+    std::size_t instances_submitted{0};
+
+    /// Number of draw calls: one per instance, or one per batch for instanced submission
+    std::size_t draw_calls{0};
+
+    /// Number of different meshes that were submitted
+    std::size_t unique_meshes{0};
+
+    /// Number of different materials that were submitted
+    std::size_t unique_materials{0};
+
+    /// Time spent on frustum and occlusion culling
+    std::chrono::nanoseconds culling_time{0};
+
+    /// Time spent on selecting levels of detail and making streamed meshes resident
+    std::chrono::nanoseconds lod_time{0};
+
+    /// Time spent on resolving, requesting and updating streamed textures
+    std::chrono::nanoseconds texture_time{0};
+
+    /// Time spent on updating the mesh instances and copying them into a snapshot
+    std::chrono::nanoseconds extract_time{0};
+
+    /// Time spent on sorting the mesh instances
+    std::chrono::nanoseconds sort_time{0};
+
+    /// Time spent on submitting the instances to the renderer
+    std::chrono::nanoseconds submit_time{0};
+
+    /// Total time spent on the frame
+    std::chrono::nanoseconds total_time{0};
+};
+
+/**
+ * @brief Receives the statistics of every frame.
+ */
+using RenderStatisticsCallback = std::function<void(const RenderStatistics&)>;
+
+} // namespace openglyph
@@ -2,11 +2,14 @@
 
 #include "environment.hpp"
 #include "game_object_type_store.hpp"
+#include "render_list.hpp"
+#include "spatial_index.hpp"
 
 #include <khepri/scene/scene.hpp>
 #include <khepri/utility/cache.hpp>
 #include <openglyph/assets/asset_cache.hpp>
 
+#include <unordered_map>
 #include <vector>
 
 namespace openglyph {
@@ -36,27 +39,112 @@ public:
     /**
      * Adds an object to the scene.
      *
-     * Does nothing if the object is already added.
+     * Does nothing if the object is already added. An object can be in one scene at a time.
      */
-    void add_object(const std::shared_ptr<khepri::scene::SceneObject>& object)
-    {
-        m_scene.add_object(object);
-    }
+    void add_object(const std::shared_ptr<khepri::scene::SceneObject>& object);
 
     /**
      * Removes an object from the scene.
      *
      * Does nothing if the object is not in the scene.
      */
-    void remove_object(const std::shared_ptr<khepri::scene::SceneObject>& object)
+    void remove_object(const std::shared_ptr<khepri::scene::SceneObject>& object);
+
+    /**
+     * Notifies the scene that an object's transform, scale or visibility has changed.
+     *
+     * The scene keeps derived state, such as its render list and spatial index, for its objects.
+     * This method updates that state for the object right away.
+     *
+     * Calling it is optional for objects with a RenderBehavior: with change detection (see
+     * #change_detection()), their changes are also found when the scene is rendered. Calling it
+     * is required for the queries of this class to reflect the change before then, for objects
+     * without a RenderBehavior, and for objects that got their RenderBehavior after they were
+     * added.
+     */
+    void update_object(const std::shared_ptr<khepri::scene::SceneObject>& object);
+
+    /**
+     * Enables or disables change detection.
+     *
+     * With change detection, which is enabled by default, every render of the scene compares the
+     * transform, scale, visibility and parameter overrides of every object with a RenderBehavior
+     * to the ones the scene last saw, and updates the objects that changed. This costs a read of
+     * every such object per frame, but no matrix products for the objects that did not change.
+     *
+     * Disable it only if every change is reported with #update_object(). Debug builds then assert
+     * when an object changed without being reported.
+     */
+    void change_detection(bool enabled) noexcept
     {
-        m_scene.remove_object(object);
+        m_change_detection = enabled;
+    }
+
+    /**
+     * Brings the scene's render list and spatial index up to date with its objects, and returns
+     * the render list.
+     *
+     * This is called by SceneRenderer when it renders the scene. It only changes state that is
+     * derived from the scene's objects, but it must not be called while the scene is queried or
+     * changed on another thread.
+     */
+    RenderList& update_render_list() const;
+
+    /**
+     * Calls @a fn with every object whose bounds intersect a box.
+     *
+     * An object's bounds enclose its render model in any orientation; objects without a model
+     * are points. @a fn is called with a khepri::scene::SceneObject&.
+     */
+    template <typename Fn>
+    void query_box(const renderer::BoundingBox& box, Fn&& fn) const
+    {
+        m_spatial_index.query_box(box, std::forward<Fn>(fn));
+    }
+
+    /// Calls @a fn with every object whose bounds intersect a sphere; see #query_box()
+    template <typename Fn>
+    void query_sphere(const khepri::Vector3f& center, float radius, Fn&& fn) const
+    {
+        m_spatial_index.query_sphere(center, radius, std::forward<Fn>(fn));
+    }
+
+    /**
+     * Calls @a fn with every object whose bounds are hit by a ray; see #query_box().
+     *
+     * The ray runs from @a origin to <tt>origin + direction * max_distance</tt>. Objects are
+     * reported in no particular order.
+     */
+    template <typename Fn>
+    void query_ray(const khepri::Vector3f& origin, const khepri::Vector3f& direction,
+                   float max_distance, Fn&& fn) const
+    {
+        m_spatial_index.query_ray(origin, direction, max_distance, std::forward<Fn>(fn));
+    }
+
+    /// Calls @a fn with every object whose bounds are (partially) inside a frustum
+    template <typename Fn>
+    void query_frustum(const renderer::Frustum& frustum, Fn&& fn) const
+    {
+        m_spatial_index.query_frustum(frustum, std::forward<Fn>(fn));
     }
 
 private:
+    // Returns the ID of an object in the spatial index, or SpatialIndex::INVALID_ID
+    [[nodiscard]] SpatialIndex::Id find(const khepri::scene::SceneObject& object) const;
+
     const GameObjectTypeStore& m_game_object_types;
 
     khepri::scene::Scene m_scene;
+    bool                 m_change_detection{true};
+
+    // State derived from the objects; brought up to date by #update_render_list()
+    mutable RenderList   m_render_list;
+    mutable SpatialIndex m_spatial_index;
+
+    // The IDs of all objects in the spatial index. Objects with a RenderBehavior also store their
+    // ID in it, which is looked up first; this map is the fallback for the other objects.
+    std::unordered_map<const khepri::scene::SceneObject*, SpatialIndex::Id> m_spatial_ids;
 
     Environment m_environment;
 };
@@ -2,7 +2,19 @@
 
 #include <khepri/renderer/camera.hpp>
 #include <khepri/renderer/renderer.hpp>
+#include <openglyph/game/render_snapshot.hpp>
+#include <openglyph/game/render_statistics.hpp>
 #include <openglyph/game/scene.hpp>
+#include <openglyph/renderer/instance_batch.hpp>
+#include <openglyph/renderer/lod_settings.hpp>
+#include <openglyph/renderer/model_streamer.hpp>
+#include <openglyph/renderer/occlusion_buffer.hpp>
+#include <openglyph/renderer/texture_streamer.hpp>
+#include <openglyph/utility/thread_pool.hpp>
+
+#include <optional>
+#include <utility>
+#include <vector>
 
 namespace openglyph {
 
@@ -11,10 +23,196 @@ class SceneRenderer
 public:
     explicit SceneRenderer(khepri::renderer::Renderer& renderer) : m_renderer(renderer) {}
 
+    /**
+     * Constructs a scene renderer that drives a texture streamer.
+     *
+     * Every frame, the screen-space size of each rendered object is reported for its textures
+     * and the streamer is updated. Streamed textures are replaced by their best resident version.
+     */
+    SceneRenderer(khepri::renderer::Renderer&           renderer,
+                  openglyph::renderer::TextureStreamer& texture_streamer)
+        : m_renderer(renderer), m_texture_streamer(&texture_streamer)
+    {}
+
+    /**
+     * Renders a scene.
+     *
+     * Objects are drawn with their current transforms: changes that were not reported with
+     * Scene::update_object() are picked up first (see Scene::change_detection()).
+     */
     void render_scene(const openglyph::Scene& scene, const khepri::renderer::Camera& camera);
 
+    /**
+     * Extracts the render data of a scene into a snapshot, for rendering with #render_snapshot().
+     *
+     * This performs the part of #render_scene() that reads the scene: culling, LoD selection and
+     * texture streaming. It must be called at a point where the scene does not change, e.g.
+     * between simulation ticks. Afterwards, the snapshot can be rendered on another thread while
+     * the simulation continues. With two snapshots, the next frame can be extracted as soon as
+     * the previous one is rendered:
+     *
+     * @code
+     * // Simulation thread, at the end of every tick:
+     * wait_for_render_thread();
+     * scene_renderer.extract(scene, camera, snapshots[frame % 2]);
+     * start_render_thread(snapshots[frame % 2]);  // calls render_snapshot()
+     * @endcode
+     *
+     * A scene renderer renders one frame at a time: this method must not be called while
+     * #render_snapshot() runs.
+     */
+    void extract(const openglyph::Scene& scene, const khepri::renderer::Camera& camera,
+                 RenderSnapshot& snapshot);
+
+    /**
+     * Renders a snapshot that was created with #extract().
+     *
+     * The snapshot is rendered with the camera it was extracted for. Does nothing if the snapshot
+     * was never extracted.
+     */
+    void render_snapshot(RenderSnapshot& snapshot);
+
+    /**
+     * Sets the instanced submission path.
+     *
+     * When set, consecutive mesh instances that share a mesh, material and material parameters
+     * are grouped into batches, and the batches are submitted through @a instanced_renderer
+     * instead of the renderer's per-instance render_meshes(). This reduces the number of draw
+     * calls to roughly the number of unique meshes.
+     *
+     * Pass an empty function to go back to per-instance submission.
+     */
+    void instanced_renderer(openglyph::renderer::InstancedRenderer instanced_renderer)
+    {
+        m_instanced_renderer = std::move(instanced_renderer);
+    }
+
+    /**
+     * Sets the thread pool to prepare the render list on.
+     *
+     * With a pool, compacting large render lists and computing their sort keys is spread over
+     * the pool's threads. The resulting draw order is the same as without a pool. Pass nullptr
+     * to prepare the render list on the calling thread only.
+     */
+    void thread_pool(ThreadPool* thread_pool) noexcept
+    {
+        m_thread_pool = thread_pool;
+    }
+
+    /**
+     * Sets the streamer of the render models in the scene.
+     *
+     * Every frame, the streamer is updated and objects pick up the more detailed meshes of their
+     * models as they become resident. Pass nullptr if models are not streamed.
+     */
+    void model_streamer(openglyph::renderer::ModelStreamer* model_streamer) noexcept
+    {
+        m_model_streamer = model_streamer;
+    }
+
+    /**
+     * Sets how the level of detail of objects is selected.
+     *
+     * By default, objects switch to less detailed LoD variants of their meshes as they get smaller
+     * on screen, using the default LodSettings. Pass std::nullopt to always render full detail.
+     */
+    void lod_settings(std::optional<openglyph::renderer::LodSettings> lod_settings)
+    {
+        m_lod_settings = std::move(lod_settings);
+    }
+
+    /**
+     * Enables or disables frustum culling.
+     *
+     * With frustum culling, which is enabled by default, only objects whose bounds intersect the
+     * camera's view frustum are prepared and submitted for rendering, and only their textures are
+     * requested from the texture streamer.
+     */
+    void frustum_culling(bool enabled) noexcept
+    {
+        m_frustum_culling = enabled;
+    }
+
+    /**
+     * Sets up occlusion culling.
+     *
+     * With occlusion culling, the objects that are largest on screen are rasterized into a
+     * low-resolution depth buffer on the CPU, using their model's occluder geometry (see
+     * RenderModel::occluder()). Objects whose bounds are entirely behind those occluders are not
+     * submitted for rendering.
+     *
+     * Occlusion culling is disabled by default. Pass std::nullopt to disable it.
+     */
+    void occlusion_culling(std::optional<openglyph::renderer::OcclusionSettings> settings);
+
+    /**
+     * Returns the statistics of the last rendered frame.
+     *
+     * Statistics are only collected if the library is built with them (see
+     * RENDER_STATISTICS_ENABLED); otherwise they are all zero.
+     */
+    [[nodiscard]] const RenderStatistics& statistics() const noexcept
+    {
+        return m_statistics;
+    }
+
+    /**
+     * Sets a function that receives the statistics after every frame.
+     *
+     * The function is never called if the library is built without statistics.
+     */
+    void statistics_callback(RenderStatisticsCallback callback)
+    {
+        m_statistics_callback = std::move(callback);
+    }
+
 private:
-    khepri::renderer::Renderer& m_renderer;
+    using InstanceBatch = openglyph::renderer::InstanceBatch;
+
+    // Counts the meshes of the processed objects
+    void count_meshes(const RenderList& render_list, bool culled, std::size_t num_instances);
+
+    // Counts the submitted instances, draw calls, meshes and materials
+    void count_submitted(gsl::span<const khepri::renderer::MeshInstance> instances);
+
+    // Removes the objects that are hidden behind the largest objects from the visible objects
+    void cull_occluded(const khepri::renderer::Camera& camera, float projection_scale);
+
+    void render_batched(gsl::span<const khepri::renderer::MeshInstance>   instances,
+                        gsl::span<const gsl::span<const std::uint32_t>> param_slots,
+                        const khepri::renderer::Camera&                   camera);
+
+    khepri::renderer::Renderer&            m_renderer;
+    openglyph::renderer::TextureStreamer*  m_texture_streamer{nullptr};
+    openglyph::renderer::ModelStreamer*    m_model_streamer{nullptr};
+    openglyph::renderer::InstancedRenderer m_instanced_renderer;
+    ThreadPool*                            m_thread_pool{nullptr};
+    bool                                   m_frustum_culling{true};
+
+    std::optional<openglyph::renderer::LodSettings> m_lod_settings{
+        openglyph::renderer::LodSettings{}};
+
+    // The snapshot used by #render_scene()
+    RenderSnapshot m_snapshot;
+
+    // Objects that remain after culling, kept to avoid reallocation
+    std::vector<const khepri::scene::SceneObject*> m_visible_objects;
+
+    std::optional<openglyph::renderer::OcclusionSettings> m_occlusion_settings;
+    std::optional<openglyph::renderer::OcclusionBuffer>   m_occlusion_buffer;
+
+    // Candidate occluders and their size on screen, kept to avoid reallocation
+    std::vector<std::pair<float, const khepri::scene::SceneObject*>> m_occluders;
+
+    // Buffers for the instanced submission path, kept to avoid reallocation
+    std::vector<InstanceBatch>   m_batches;
+    std::vector<khepri::Matrixf> m_batch_transforms;
+
+    RenderStatistics         m_statistics;
+    RenderStatisticsCallback m_statistics_callback;
+
+    // Buffer for counting unique meshes and materials, kept to avoid reallocation
+    std::vector<const void*> m_unique_buffer;
 };
 
 } // namespace openglyph
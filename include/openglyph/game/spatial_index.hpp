@@ -0,0 +1,276 @@
+#pragma once
+
+#include <khepri/scene/scene_object.hpp>
+#include <openglyph/renderer/bounding_box.hpp>
+#include <openglyph/renderer/frustum.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace openglyph {
+
+/**
+ * @brief Spatial index of scene objects.
+ *
+ * The index is a dynamic bounding volume hierarchy: a binary tree of axis-aligned boxes whose
+ * leaves are the objects. The tree is kept balanced with tree rotations as objects are inserted
+ * and removed, so queries visit O(log n) nodes plus the nodes of the results.
+ *
+ * Leaves store a box that is enlarged by a margin. Objects that move within that box only need
+ * their exact bounds updated; only objects that move out of it are re-inserted.
+ */
+class SpatialIndex final
+{
+public:
+    using BoundingBox = renderer::BoundingBox;
+    using Frustum     = renderer::Frustum;
+
+    /// Identifies an object in the index
+    using Id = std::uint32_t;
+
+    /// An invalid ID
+    static constexpr Id INVALID_ID = std::numeric_limits<Id>::max();
+
+    /**
+     * Constructs an empty index.
+     *
+     * @param margin the margin to enlarge leaf boxes with, relative to their size
+     */
+    explicit SpatialIndex(float margin = 0.25f) : m_margin(margin) {}
+
+    /// Inserts an object with the given bounds and returns its ID
+    Id insert(const BoundingBox& bounds, khepri::scene::SceneObject& object);
+
+    /// Removes an object from the index
+    void remove(Id id);
+
+    /**
+     * Updates the bounds of an object.
+     *
+     * @return true if the object had to be moved in the tree.
+     */
+    bool update(Id id, const BoundingBox& bounds);
+
+    /// Returns true if @a id identifies @a object in the index
+    [[nodiscard]] bool contains(Id id, const khepri::scene::SceneObject& object) const noexcept
+    {
+        return id < m_nodes.size() && m_nodes[id].height == 0 && m_nodes[id].object == &object;
+    }
+
+    /// Returns the number of objects in the index
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return m_size;
+    }
+
+    /// Returns the height of the tree; 0 for an empty or single-object tree
+    [[nodiscard]] int height() const noexcept
+    {
+        return m_root == INVALID_ID ? 0 : m_nodes[m_root].height;
+    }
+
+    /// Calls @a fn for every object whose bounds intersect @a box
+    template <typename Fn>
+    void query_box(const BoundingBox& box, Fn&& fn) const
+    {
+        traverse([&](const BoundingBox& bounds) { return bounds.intersects(box); }, fn);
+    }
+
+    /// Calls @a fn for every object whose bounds intersect the sphere
+    template <typename Fn>
+    void query_sphere(const khepri::Vector3f& center, float radius, Fn&& fn) const
+    {
+        traverse(
+            [&](const BoundingBox& bounds) {
+                // Squared distance from the center to the closest point in the box
+                const auto dx = std::max({bounds.min.x - center.x, 0.0f, center.x - bounds.max.x});
+                const auto dy = std::max({bounds.min.y - center.y, 0.0f, center.y - bounds.max.y});
+                const auto dz = std::max({bounds.min.z - center.z, 0.0f, center.z - bounds.max.z});
+                return dx * dx + dy * dy + dz * dz <= radius * radius;
+            },
+            fn);
+    }
+
+    /**
+     * Calls @a fn for every object whose bounds are hit by a ray.
+     *
+     * @param origin the start of the ray
+     * @param direction the direction of the ray
+     * @param max_distance the length of the ray, in multiples of @a direction
+     */
+    template <typename Fn>
+    void query_ray(const khepri::Vector3f& origin, const khepri::Vector3f& direction,
+                   float max_distance, Fn&& fn) const
+    {
+        const float inf      = std::numeric_limits<float>::infinity();
+        const float start[3] = {origin.x, origin.y, origin.z};
+        const float dir[3]   = {direction.x, direction.y, direction.z};
+        const float inv[3]   = {dir[0] != 0 ? 1 / dir[0] : inf, dir[1] != 0 ? 1 / dir[1] : inf,
+                              dir[2] != 0 ? 1 / dir[2] : inf};
+        traverse(
+            [&](const BoundingBox& bounds) {
+                // Slab test
+                const float lo[3] = {bounds.min.x, bounds.min.y, bounds.min.z};
+                const float hi[3] = {bounds.max.x, bounds.max.y, bounds.max.z};
+                float       t_min = 0;
+                float       t_max = max_distance;
+                for (int axis = 0; axis < 3; ++axis) {
+                    if (dir[axis] == 0) {
+                        if (start[axis] < lo[axis] || start[axis] > hi[axis]) {
+                            return false;
+                        }
+                        continue;
+                    }
+                    const float t1 = (lo[axis] - start[axis]) * inv[axis];
+                    const float t2 = (hi[axis] - start[axis]) * inv[axis];
+                    t_min          = std::max(t_min, std::min(t1, t2));
+                    t_max          = std::min(t_max, std::max(t1, t2));
+                }
+                return t_min <= t_max;
+            },
+            fn);
+    }
+
+    /**
+     * Calls @a fn for every object whose bounds are (partially) inside a frustum.
+     *
+     * Subtrees that are entirely inside the frustum are reported without further tests, so this
+     * takes O(log n + results) time.
+     */
+    template <typename Fn>
+    void query_frustum(const Frustum& frustum, Fn&& fn) const
+    {
+        if (m_root == INVALID_ID) {
+            return;
+        }
+        NodeStack<std::pair<Id, bool>> stack;
+        stack.push({m_root, false});
+        while (!stack.empty()) {
+            const auto [id, inside] = stack.pop();
+
+            const auto& node        = m_nodes[id];
+            bool        node_inside = inside;
+            if (!inside) {
+                const auto containment = frustum.classify(node.is_leaf() ? node.bounds : node.box);
+                if (containment == Frustum::Containment::outside) {
+                    continue;
+                }
+                node_inside = containment == Frustum::Containment::inside;
+            }
+            if (node.is_leaf()) {
+                fn(*node.object);
+            } else {
+                stack.push({node.child1, node_inside});
+                stack.push({node.child2, node_inside});
+            }
+        }
+    }
+
+private:
+    struct Node
+    {
+        // Bounds of all leaves below this node; for a leaf, the enlarged bounds of its object
+        BoundingBox box;
+
+        // Exact bounds of the object; leaves only
+        BoundingBox bounds;
+
+        // Parent node, or next free node if this node is free
+        Id parent{INVALID_ID};
+        Id child1{INVALID_ID};
+        Id child2{INVALID_ID};
+
+        // Height of the subtree; 0 for leaves, -1 for free nodes
+        int height{-1};
+
+        khepri::scene::SceneObject* object{nullptr};
+
+        [[nodiscard]] bool is_leaf() const noexcept
+        {
+            return child1 == INVALID_ID;
+        }
+    };
+
+    // Stack of nodes that a query has yet to visit. Queries on the balanced tree need at most
+    // height + 1 entries, which fit in the inline storage for any practical number of objects, so
+    // queries do not allocate. Deeper stacks spill to the heap.
+    template <typename T>
+    class NodeStack final
+    {
+    public:
+        void push(const T& value)
+        {
+            if (m_size < INLINE_SIZE) {
+                m_inline[m_size] = value;
+            } else {
+                m_overflow.push_back(value);
+            }
+            ++m_size;
+        }
+
+        T pop() noexcept
+        {
+            --m_size;
+            if (m_size < INLINE_SIZE) {
+                return m_inline[m_size];
+            }
+            const T value = m_overflow.back();
+            m_overflow.pop_back();
+            return value;
+        }
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return m_size == 0;
+        }
+
+    private:
+        static constexpr std::size_t INLINE_SIZE = 64;
+
+        std::array<T, INLINE_SIZE> m_inline{};
+        std::size_t                m_size{0};
+        std::vector<T>             m_overflow;
+    };
+
+    template <typename Test, typename Fn>
+    void traverse(const Test& test, Fn& fn) const
+    {
+        if (m_root == INVALID_ID) {
+            return;
+        }
+        NodeStack<Id> stack;
+        stack.push(m_root);
+        while (!stack.empty()) {
+            const auto& node = m_nodes[stack.pop()];
+            if (node.is_leaf()) {
+                if (test(node.bounds)) {
+                    fn(*node.object);
+                }
+            } else if (test(node.box)) {
+                stack.push(node.child1);
+                stack.push(node.child2);
+            }
+        }
+    }
+
+    BoundingBox enlarge(const BoundingBox& bounds) const noexcept;
+
+    Id   allocate_node();
+    void free_node(Id id) noexcept;
+    void insert_leaf(Id leaf);
+    void remove_leaf(Id leaf);
+    Id   balance(Id id);
+
+    float             m_margin;
+    std::vector<Node> m_nodes;
+    Id                m_root{INVALID_ID};
+    Id                m_free_list{INVALID_ID};
+    std::size_t       m_size{0};
+};
+
+} // namespace openglyph
@@ -29,20 +29,32 @@ public:
 
     /**
      * Returns the ID of the current chunk
-     * \throws khepri::io::error if #has_chunks() is false
+     * \throws khepri::io::error if #has_chunk() is false
      */
     ChunkId id() const;
 
     /**
      * Does the current chunk contain data or chunks?
-     * \throws khepri::io::error if #has_chunks() is false
+     * \throws khepri::io::error if #has_chunk() is false
      */
     bool has_data() const;
 
+    /**
+     * Returns the position of the current chunk's contents in the stream
+     * \throws khepri::io::error if #has_chunk() is false
+     */
+    long long offset() const;
+
+    /**
+     * Returns the size of the current chunk's contents
+     * \throws khepri::io::error if #has_chunk() is false
+     */
+    long long size() const;
+
     /**
      * Reads the current chunk's data.
      *
-     * \throws khepri::io::error if #has_chunks() is false, #has_data() is false or an I/O error
+     * \throws khepri::io::error if #has_chunk() is false, #has_data() is false or an I/O error
      * occured.
      */
     std::vector<std::uint8_t> read_data();
@@ -54,7 +66,7 @@ public:
 
     /**
      * Advances the reader to the next chunk.
-     * \throws khepri::io::error if #has_chunks() is false or an I/O error occured.
+     * \throws khepri::io::error if #has_chunk() is false or an I/O error occured.
      * \note This invalidates any returned streams or child chunk_readers.
      */
     void next();
@@ -62,7 +74,7 @@ public:
     /**
      * Opens the current chunk.
      *
-     * \throws khepri::io::error if #has_chunks() is false, #data() is true or an I/O error occured.
+     * \throws khepri::io::error if #has_chunk() is false, #data() is true or an I/O error occured.
      */
     void open();
 
@@ -106,13 +118,13 @@ public:
 
     /**
      * Returns the ID of the current mini-chunk
-     * \throws khepri::io::error if #has_chunks() is true
+     * \throws khepri::io::error if #has_chunk() is true
      */
     ChunkId id() const;
 
     /**
      * Reads the current mini-chunk's data.
-     * \throws khepri::io::error if #has_chunks() is true
+     * \throws khepri::io::error if #has_chunk() is true
      */
     gsl::span<const std::uint8_t> read_data() const;
 
@@ -123,7 +135,7 @@ public:
 
     /**
      * Advances the reader to the next mini-chunk.
-     * \throws khepri::io::error if #has_chunks() is false or an I/O error occured.
+     * \throws khepri::io::error if #has_chunk() is false or an I/O error occured.
      */
     void next();
 
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <gsl/gsl-lite.hpp>
+#include <khepri/io/stream.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace openglyph::io {
+
+/**
+ * @brief A read-only memory mapping of an entire file.
+ *
+ * The operating system pages the file's contents in on access, so mapping a large file is cheap
+ * and only the parts that are read take up memory.
+ */
+class MappedFile final
+{
+public:
+    /**
+     * Maps a file into memory.
+     *
+     * \param[in] path the path of the file to map.
+     *
+     * \throws khepri::io::Error if the file cannot be opened or mapped.
+     */
+    explicit MappedFile(const std::filesystem::path& path);
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    /// Returns the contents of the file
+    [[nodiscard]] gsl::span<const std::uint8_t> data() const noexcept
+    {
+        return {m_data, m_size};
+    }
+
+private:
+    const std::uint8_t* m_data{nullptr};
+    std::size_t         m_size{0};
+#ifdef _WIN32
+    void* m_file{nullptr};
+    void* m_mapping{nullptr};
+#endif
+};
+
+/**
+ * @brief A read-only stream over a block of memory.
+ *
+ * \note The caller must ensure that the memory is kept alive while this object is alive.
+ */
+class MemoryStream final : public khepri::io::Stream
+{
+public:
+    /**
+     * Constructs a memory stream.
+     *
+     * \param[in] data the memory to read from.
+     */
+    explicit MemoryStream(gsl::span<const std::uint8_t> data) noexcept : m_data(data) {}
+
+    /// \see #khepri::io::Stream::readable
+    [[nodiscard]] bool readable() const noexcept override
+    {
+        return true;
+    }
+
+    /// \see #khepri::io::Stream::writable
+    [[nodiscard]] bool writable() const noexcept override
+    {
+        return false;
+    }
+
+    /// \see #khepri::io::Stream::seekable
+    [[nodiscard]] bool seekable() const noexcept override
+    {
+        return true;
+    }
+
+    /// \see #khepri::io::Stream::read
+    std::size_t read(void* buffer, std::size_t count) override;
+
+    /// \see #khepri::io::Stream::write
+    std::size_t write(const void* buffer, std::size_t count) override;
+
+    /// \see #khepri::io::Stream::seek
+    long long seek(long long offset, khepri::io::SeekOrigin origin) override;
+
+private:
+    gsl::span<const std::uint8_t> m_data;
+    std::size_t                   m_pos{0};
+};
+
+} // namespace openglyph::io
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <khepri/math/vector3.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace openglyph::renderer {
+
+/**
+ * An axis-aligned bounding box
+ */
+struct BoundingBox
+{
+    khepri::Vector3f min{0, 0, 0}; ///< Minimum corner of the box
+    khepri::Vector3f max{0, 0, 0}; ///< Maximum corner of the box
+
+    /// Returns the center of the box
+    [[nodiscard]] khepri::Vector3f center() const noexcept
+    {
+        return {(min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f, (min.z + max.z) * 0.5f};
+    }
+
+    /// Returns the radius of the sphere around the box's center that encloses the box
+    [[nodiscard]] float radius() const noexcept
+    {
+        const float dx = max.x - min.x;
+        const float dy = max.y - min.y;
+        const float dz = max.z - min.z;
+        return std::sqrt(dx * dx + dy * dy + dz * dz) * 0.5f;
+    }
+
+    /// Returns half the surface area of the box
+    [[nodiscard]] float half_area() const noexcept
+    {
+        const float dx = max.x - min.x;
+        const float dy = max.y - min.y;
+        const float dz = max.z - min.z;
+        return dx * dy + dy * dz + dz * dx;
+    }
+
+    /// Returns true if @a other lies entirely within the box
+    [[nodiscard]] bool contains(const BoundingBox& other) const noexcept
+    {
+        return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z &&
+               max.x >= other.max.x && max.y >= other.max.y && max.z >= other.max.z;
+    }
+
+    /// Returns true if the box and @a other overlap
+    [[nodiscard]] bool intersects(const BoundingBox& other) const noexcept
+    {
+        return min.x <= other.max.x && min.y <= other.max.y && min.z <= other.max.z &&
+               max.x >= other.min.x && max.y >= other.min.y && max.z >= other.min.z;
+    }
+
+    /// Grows the box to also enclose @a other
+    void merge(const BoundingBox& other) noexcept
+    {
+        min = {std::min(min.x, other.min.x), std::min(min.y, other.min.y),
+               std::min(min.z, other.min.z)};
+        max = {std::max(max.x, other.max.x), std::max(max.y, other.max.y),
+               std::max(max.z, other.max.z)};
+    }
+};
+
+} // namespace openglyph::renderer
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "bounding_box.hpp"
+
+#include <khepri/math/matrix.hpp>
+#include <openglyph/utility/matrix_layout.hpp>
+
+#include <array>
+#include <cmath>
+
+namespace openglyph::renderer {
+
+/**
+ * @brief A view frustum, for culling.
+ *
+ * The frustum is defined by six planes whose normals point inwards.
+ */
+class Frustum final
+{
+public:
+    /// Result of classifying a volume against the frustum
+    enum class Containment
+    {
+        outside,
+        intersects,
+        inside,
+    };
+
+    /// A plane: the points p for which <tt>dot(normal, p) + distance == 0</tt>
+    struct Plane
+    {
+        khepri::Vector3f normal;
+        float            distance;
+    };
+
+    /**
+     * Extracts the frustum from a camera's combined view and projection matrix.
+     *
+     * The near plane is placed at clip-space z = -w, which is the near plane for OpenGL-style
+     * depth ranges and a conservative one for Direct3D-style depth ranges.
+     */
+    static Frustum from_matrices(const khepri::Matrixf& view_proj) noexcept
+    {
+        const auto  clip = transform_coefficients(view_proj);
+        const auto& x    = clip[0];
+        const auto& y    = clip[1];
+        const auto& z    = clip[2];
+        const auto& w    = clip[3];
+
+        Frustum frustum;
+        frustum.m_planes = {plane(w, x, 1), plane(w, x, -1), plane(w, y, 1),
+                            plane(w, y, -1), plane(w, z, 1), plane(w, z, -1)};
+        return frustum;
+    }
+
+    /// Returns the frustum's planes
+    [[nodiscard]] const auto& planes() const noexcept
+    {
+        return m_planes;
+    }
+
+    /// Classifies a box against the frustum
+    [[nodiscard]] Containment classify(const BoundingBox& box) const noexcept
+    {
+        auto result = Containment::inside;
+        for (const auto& plane : m_planes) {
+            // Test the box corner that is farthest along the plane normal, and the opposite one
+            const auto& n = plane.normal;
+            const auto  p = khepri::Vector3f{n.x >= 0 ? box.max.x : box.min.x,
+                                            n.y >= 0 ? box.max.y : box.min.y,
+                                            n.z >= 0 ? box.max.z : box.min.z};
+            const auto  q = khepri::Vector3f{n.x >= 0 ? box.min.x : box.max.x,
+                                            n.y >= 0 ? box.min.y : box.max.y,
+                                            n.z >= 0 ? box.min.z : box.max.z};
+            if (n.x * p.x + n.y * p.y + n.z * p.z + plane.distance < 0) {
+                return Containment::outside;
+            }
+            if (n.x * q.x + n.y * q.y + n.z * q.z + plane.distance < 0) {
+                result = Containment::intersects;
+            }
+        }
+        return result;
+    }
+
+private:
+    // Creates the normalized plane w + sign * c >= 0
+    static Plane plane(const std::array<float, 4>& w, const std::array<float, 4>& c,
+                       float sign) noexcept
+    {
+        const khepri::Vector3f normal{w[0] + sign * c[0], w[1] + sign * c[1], w[2] + sign * c[2]};
+        const float            distance = w[3] + sign * c[3];
+        const float            length =
+            std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+        const float scale = length > 0 ? 1 / length : 0;
+        return {{normal.x * scale, normal.y * scale, normal.z * scale}, distance * scale};
+    }
+
+    std::array<Plane, 6> m_planes{};
+};
+
+} // namespace openglyph::renderer
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <gsl/gsl-lite.hpp>
+#include <khepri/renderer/camera.hpp>
+#include <khepri/renderer/material.hpp>
+#include <khepri/renderer/mesh.hpp>
+
+#include <cstdint>
+#include <functional>
+
+namespace openglyph::renderer {
+
+/**
+ * @brief A group of instances of one mesh that can be drawn with a single instanced draw call.
+ *
+ * All instances in a batch share the mesh, the material and the material parameters; they only
+ * differ in their transform.
+ */
+struct InstanceBatch
+{
+    /// The mesh to draw
+    const khepri::renderer::Mesh* mesh{nullptr};
+
+    /// The material to draw the mesh with
+    const khepri::renderer::Material* material{nullptr};
+
+    /// The material parameters shared by all instances
+    gsl::span<const khepri::renderer::Material::Param> material_params;
+
+    /// The shader property slot of each material parameter, so the parameters can be bound
+    /// without matching their names. Empty if the material is not known. Parameters with slot
+    /// MaterialInfo::NO_SLOT are not listed by the material and must be bound by name.
+    gsl::span<const std::uint32_t> param_slots;
+
+    /// The transform of every instance, in draw order
+    gsl::span<const khepri::Matrixf> transforms;
+};
+
+/**
+ * @brief Submits instance batches to a renderer with instanced draws.
+ *
+ * The batches are passed in the order they must be drawn in.
+ */
+using InstancedRenderer =
+    std::function<void(gsl::span<const InstanceBatch>, const khepri::renderer::Camera&)>;
+
+} // namespace openglyph::renderer
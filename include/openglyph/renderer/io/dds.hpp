@@ -0,0 +1,66 @@
+#pragma once
+
+#include <khepri/io/stream.hpp>
+#include <khepri/renderer/texture_desc.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace openglyph::renderer::io {
+
+/**
+ * @brief The layout of the mip levels of a DDS file.
+ *
+ * Allows mip levels to be read straight from the file without parsing or reading all of it.
+ */
+struct DdsLayout
+{
+    /// The file's headers, including the magic number and the optional DX10 header
+    std::vector<std::uint8_t> header;
+
+    /// Size of the top mip level
+    unsigned long width{0}, height{0}, depth{1};
+
+    /// Number of mip levels of each slice
+    unsigned int mip_levels{1};
+
+    /// Number of images (array elements times cube faces) of mip levels
+    unsigned int slices{1};
+
+    /// Size of each mip level of a single slice, in bytes
+    std::vector<std::size_t> mip_sizes;
+
+    /// Size of a 4x4 block for block-compressed formats, or 0
+    std::size_t block_size{0};
+
+    /// Size of a pixel for uncompressed formats, in bits
+    unsigned int bits_per_pixel{0};
+};
+
+/**
+ * @brief Reads the layout of a DDS file.
+ *
+ * @param stream the stream to read the DDS file from.
+ *
+ * @return the layout, or an empty optional if the stream does not contain a DDS file of a format
+ *         whose layout is understood.
+ */
+std::optional<DdsLayout> read_dds_layout(khepri::io::Stream& stream);
+
+/**
+ * @brief Loads the mip levels of a DDS file, starting at a given level.
+ *
+ * Only the requested mip levels are read from the stream.
+ *
+ * @param stream the stream to read the DDS file from.
+ * @param layout the layout of the DDS file, as returned by #read_dds_layout().
+ * @param top_mip the first mip level to load.
+ *
+ * @throws khepri::io::Error if the mip levels cannot be read.
+ */
+khepri::renderer::TextureDesc load_dds_mips(khepri::io::Stream& stream, const DdsLayout& layout,
+                                            unsigned int top_mip);
+
+} // namespace openglyph::renderer::io
@@ -1,8 +1,17 @@
 #pragma once
 
+#include <gsl/gsl-lite.hpp>
 #include <khepri/io/stream.hpp>
+#include <openglyph/io/chunk_reader.hpp>
+#include <openglyph/io/mapped_file.hpp>
 #include <openglyph/renderer/model.hpp>
 
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
 namespace openglyph::io {
 
 /**
@@ -10,7 +19,136 @@ namespace openglyph::io {
  *
  * Reads a stream containing a binary Alamo Object (ALO) model and returns a renderer-agnostic
  * description of the model.
+ *
+ * @param stream the stream to read the model from
+ * @param vertex_format the format to store the vertices in. With the compact format, only the
+ *                      materials' @c compact_vertices are filled, which takes less than half
+ *                      the memory of the full format.
  */
-openglyph::renderer::Model read_model(khepri::io::Stream& stream);
+openglyph::renderer::Model
+read_model(khepri::io::Stream&                     stream,
+           openglyph::renderer::Model::VertexFormat vertex_format =
+               openglyph::renderer::Model::VertexFormat::full);
+
+/**
+ * @brief A lazily decoded view of an ALO model.
+ *
+ * Constructing a view only indexes the model's chunks and reads the meshes' names, LoD and Alt
+ * levels, visibility and bounding boxes. A material's shader parameters, vertices and indices are
+ * decoded on the first access to that material, and kept for later accesses.
+ *
+ * A view over a file memory-maps the file, so opening a huge model is fast and only the parts of
+ * the file that are decoded are read from disk.
+ *
+ * \note Decoding modifies the view, so a view must not be accessed from multiple threads at once.
+ */
+class ModelView final
+{
+public:
+    using Model = openglyph::renderer::Model;
+
+    /// Information about a mesh that is available without decoding it
+    struct MeshInfo
+    {
+        Symbol                           name;              ///< The mesh's name
+        unsigned int                     lod{0};            ///< The mesh's LoD level
+        unsigned int                     alt{0};            ///< The mesh's Alt level
+        bool                             visible{false};    ///< The mesh's initial visibility
+        openglyph::renderer::BoundingBox bounding_box;      ///< The mesh's bounding box
+        std::size_t                      material_count{0}; ///< The number of materials
+    };
+
+    /**
+     * Opens a view of an ALO file.
+     *
+     * \param[in] path the path of the model file.
+     * \param[in] vertex_format the format to store decoded vertices in.
+     *
+     * \throws khepri::io::Error if the file cannot be mapped or is not a valid model, or if it
+     * contains no meshes.
+     */
+    explicit ModelView(const std::filesystem::path& path,
+                       Model::VertexFormat          vertex_format = Model::VertexFormat::full);
+
+    /**
+     * Opens a view of an ALO model in memory.
+     *
+     * \param[in] data the contents of the model.
+     * \param[in] vertex_format the format to store decoded vertices in.
+     *
+     * \throws khepri::io::Error if @a data is not a valid model or contains no meshes.
+     *
+     * \note The caller must ensure that @a data is kept alive while this object is alive.
+     */
+    explicit ModelView(gsl::span<const std::uint8_t> data,
+                       Model::VertexFormat           vertex_format = Model::VertexFormat::full);
+
+    ModelView(const ModelView&) = delete;
+    ModelView(ModelView&&)      = default;
+    ModelView& operator=(const ModelView&) = delete;
+    ModelView& operator=(ModelView&&) = default;
+    ~ModelView();
+
+    /// Returns the number of meshes in the model
+    [[nodiscard]] std::size_t mesh_count() const noexcept
+    {
+        return m_meshes.size();
+    }
+
+    /**
+     * Returns information about a mesh.
+     * \throws std::out_of_range if @a mesh is not a valid mesh index.
+     */
+    [[nodiscard]] const MeshInfo& mesh(std::size_t mesh) const
+    {
+        return m_meshes.at(mesh).info;
+    }
+
+    /**
+     * Returns a material of a mesh, decoding it if it has not been accessed before.
+     *
+     * \throws std::out_of_range if @a mesh or @a material is not a valid index.
+     * \throws khepri::io::Error if the material's data is not valid.
+     */
+    const Model::Material& material(std::size_t mesh, std::size_t material);
+
+    /**
+     * Returns a material of a mesh with only its name and parameters decoded.
+     *
+     * Its vertices and indices are empty, unless the material was accessed with #material().
+     *
+     * \throws std::out_of_range if @a mesh or @a material is not a valid index.
+     * \throws khepri::io::Error if the material's data is not valid.
+     */
+    const Model::Material& shader(std::size_t mesh, std::size_t material);
+
+    /// Returns true if a material of a mesh has been decoded with #material()
+    [[nodiscard]] bool is_decoded(std::size_t mesh, std::size_t material) const;
+
+private:
+    // The chunks of a material and the material, as far as it is decoded
+    struct Submesh
+    {
+        gsl::span<const std::uint8_t> geometry;
+        gsl::span<const std::uint8_t> shader;
+        Model::Material               material;
+        bool                          shader_decoded{false};
+        bool                          geometry_decoded{false};
+    };
+
+    struct Mesh
+    {
+        MeshInfo             info;
+        std::vector<Submesh> submeshes;
+    };
+
+    void index(ChunkReader& reader);
+    void index_mesh(ChunkReader& reader);
+
+    std::unique_ptr<MappedFile>   m_file;
+    gsl::span<const std::uint8_t> m_data;
+    Model::VertexFormat           m_vertex_format;
+    std::vector<Mesh>             m_meshes;
+};
 
 } // namespace openglyph::io
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace openglyph::renderer {
+
+/**
+ * @brief Settings for selecting a mesh's level of detail by its size on screen.
+ *
+ * The screen size of an object is the radius of its bounds relative to half the screen height.
+ * Every threshold that an object's screen size falls below reduces its detail by one level, down
+ * to the lowest level the mesh has.
+ */
+struct LodSettings
+{
+    /// Screen sizes below which detail is reduced by one more level, in decreasing order
+    std::vector<float> thresholds{0.25f, 0.1f, 0.04f, 0.015f};
+
+    /**
+     * Relative margin around each threshold.
+     *
+     * Detail is only reduced once the screen size is @a hysteresis below a threshold, and only
+     * increased once it is @a hysteresis above it, so objects near a threshold do not switch
+     * levels every frame.
+     */
+    float hysteresis{0.1f};
+};
+
+/**
+ * Selects the detail reduction for an object.
+ *
+ * @param screen_size the object's current screen size
+ * @param current the object's current detail reduction
+ * @param settings the LOD settings
+ * @return the number of levels to reduce the object's detail by
+ */
+inline unsigned int select_lod_reduction(float screen_size, unsigned int current,
+                                         const LodSettings& settings) noexcept
+{
+    const auto& thresholds = settings.thresholds;
+
+    auto reduction = std::min<std::size_t>(current, thresholds.size());
+    while (reduction < thresholds.size() &&
+           screen_size < thresholds[reduction] * (1 - settings.hysteresis)) {
+        ++reduction;
+    }
+    while (reduction > 0 && screen_size >= thresholds[reduction - 1] * (1 + settings.hysteresis)) {
+        --reduction;
+    }
+    return static_cast<unsigned int>(reduction);
+}
+
+} // namespace openglyph::renderer
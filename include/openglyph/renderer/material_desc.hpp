@@ -1,6 +1,7 @@
 #pragma once
 
 #include <khepri/renderer/material_desc.hpp>
+#include <openglyph/utility/symbol.hpp>
 
 #include <variant>
 
@@ -23,14 +24,14 @@ struct MaterialDesc
     struct Property
     {
         /// Property name
-        std::string name;
+        Symbol name;
 
         /// Default value of the property if none is provided by the mesh instance
         PropertyValue default_value;
     };
 
     /// Name of the material
-    std::string name;
+    Symbol name;
 
     /// Type of alpha blending to use when rendering with this material
     AlphaBlendMode alpha_blend_mode{AlphaBlendMode::none};
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "sort_key.hpp"
+
+#include <openglyph/utility/symbol.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace openglyph::renderer {
+
+/**
+ * @brief Information about a registered material that is needed to prepare meshes for it.
+ */
+struct MaterialInfo
+{
+    /// Slot of material parameters that the material's properties do not list. Such parameters
+    /// are still passed on, and must be bound by name.
+    static constexpr std::uint32_t NO_SLOT = std::numeric_limits<std::uint32_t>::max();
+
+    /// Properties that determine the draw order of the material
+    MaterialSortInfo sort_info;
+
+    /// Names of the material's shader properties. The index of a property is its slot.
+    std::vector<Symbol> properties;
+
+    /**
+     * Returns the slot of a shader property.
+     *
+     * @return the slot, or std::nullopt if the material has no property with that name.
+     */
+    [[nodiscard]] std::optional<std::uint32_t> slot(Symbol name) const noexcept
+    {
+        const auto it = std::find(properties.begin(), properties.end(), name);
+        if (it == properties.end()) {
+            return {};
+        }
+        return static_cast<std::uint32_t>(it - properties.begin());
+    }
+};
+
+} // namespace openglyph::renderer
@@ -1,16 +1,20 @@
 #pragma once
 
 #include "material_desc.hpp"
+#include "material_info.hpp"
 
 #include <gsl/gsl-lite.hpp>
 #include <khepri/renderer/renderer.hpp>
 #include <khepri/renderer/shader.hpp>
 #include <khepri/renderer/texture.hpp>
 #include <khepri/utility/string.hpp>
+#include <openglyph/utility/symbol.hpp>
+#include <openglyph/utility/thread_pool.hpp>
 
-#include <map>
 #include <memory>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <utility>
 
 namespace openglyph::renderer {
@@ -21,32 +25,120 @@ public:
     template <typename T>
     using Loader = std::function<T*(std::string_view)>;
 
+    /// When registered materials are instantiated
+    enum class Mode
+    {
+        /// Materials, their shaders and default textures are created when they're registered
+        immediate,
+
+        /// Only the material descriptions are stored when registered; the material, its shader
+        /// and default textures are created on the first #get() of the material
+        lazy,
+
+        /// Materials are created when they're registered, but all unique shaders and default
+        /// textures of the registered materials are first loaded in parallel on the store's
+        /// #thread_pool(). In this mode, the shader and texture loaders must be thread-safe.
+        parallel,
+    };
+
     MaterialStore(khepri::renderer::Renderer&       renderer,
                   Loader<khepri::renderer::Shader>  shader_loader,
-                  Loader<khepri::renderer::Texture> texture_loader)
+                  Loader<khepri::renderer::Texture> texture_loader, Mode mode = Mode::immediate)
         : m_renderer(renderer)
         , m_shader_loader(std::move(shader_loader))
         , m_texture_loader(std::move(texture_loader))
+        , m_mode(mode)
     {}
 
     void register_materials(gsl::span<const MaterialDesc> material_descs);
 
-    khepri::renderer::Material* get(std::string_view name) const noexcept;
+    /**
+     * Sets the thread pool to load shaders and textures on in Mode::parallel.
+     *
+     * The pool is only used during #register_materials(). Pass nullptr to load them on the
+     * calling thread.
+     */
+    void thread_pool(ThreadPool* thread_pool) noexcept
+    {
+        m_thread_pool = thread_pool;
+    }
+
+    /**
+     * Finds a material by name.
+     *
+     * In lazy mode, this instantiates the material on first use.
+     *
+     * @return the material, or nullptr if no material with that name was registered.
+     */
+    khepri::renderer::Material* get(Symbol name);
+
+    /// @copydoc get(Symbol)
+    khepri::renderer::Material* get(std::string_view name)
+    {
+        const auto symbol = Symbol::find(name);
+        return symbol ? get(*symbol) : nullptr;
+    }
+
+    /**
+     * Finds the information of a material by name.
+     *
+     * Unlike #get(), this never instantiates the material. The returned pointer remains valid
+     * for the lifetime of the store.
+     *
+     * @return the information, or nullptr if no material with that name was registered.
+     */
+    const MaterialInfo* info(Symbol name) const noexcept;
+
+    /// @copydoc info(Symbol) const
+    const MaterialInfo* info(std::string_view name) const
+    {
+        const auto symbol = Symbol::find(name);
+        return symbol ? info(*symbol) : nullptr;
+    }
 
     auto as_loader()
     {
-        return [this](std::string_view id) { return this->get(id); };
+        return [this](Symbol id) { return this->get(id); };
+    }
+
+    auto as_info_loader() const
+    {
+        return [this](Symbol id) { return this->info(id); };
     }
 
 private:
-    using MaterialMap = std::map<std::string, std::unique_ptr<khepri::renderer::Material>,
-                                 khepri::CaseInsensitiveLess>;
+    struct Entry
+    {
+        // Description of the material; only set while the material hasn't been created yet
+        std::optional<MaterialDesc> desc;
+
+        std::unique_ptr<khepri::renderer::Material> material;
+
+        MaterialInfo info;
+    };
+
+    using MaterialMap = std::unordered_map<Symbol, Entry>;
+
+    std::unique_ptr<khepri::renderer::Material>
+    create_material(const MaterialDesc& desc, const Loader<khepri::renderer::Shader>& shader_loader,
+                    const Loader<khepri::renderer::Texture>& texture_loader);
+
+    void register_materials_parallel(gsl::span<const MaterialDesc> material_descs);
+
+    // Adds an entry for the material, with its information filled in.
+    // Returns nullptr if a material with the same name was already registered.
+    Entry* add_entry(const MaterialDesc& desc);
 
     khepri::renderer::Renderer&       m_renderer;
     Loader<khepri::renderer::Shader>  m_shader_loader;
     Loader<khepri::renderer::Texture> m_texture_loader;
+    Mode                              m_mode;
+    ThreadPool*                       m_thread_pool{nullptr};
 
     MaterialMap m_materials;
+
+    // Index of every shader used by the registered materials, in order of first use
+    std::unordered_map<Symbol, std::uint32_t> m_shader_indices;
 };
 
 } // namespace openglyph::renderer
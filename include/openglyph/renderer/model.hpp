@@ -1,10 +1,12 @@
 #pragma once
 
+#include "bounding_box.hpp"
 #include "material_desc.hpp"
 
 #include <khepri/math/color_rgba.hpp>
 #include <khepri/math/vector3.hpp>
 #include <khepri/math/vector4.hpp>
+#include <openglyph/utility/symbol.hpp>
 
 #include <cstdint>
 #include <string>
@@ -38,6 +40,32 @@ public:
         khepri::ColorRGBA color;    ///< Color (in linear color space)
     };
 
+    /**
+     * A vertex in compact form, for keeping many models in memory.
+     *
+     * The normal and tangent are octahedral-encoded unit vectors in signed normalized 16-bit
+     * form. The binormal is not stored: it is the cross product of the normal and tangent,
+     * negated if the lowest bit of @c tangent[1] is set. See compress_vertices().
+     */
+    struct CompactVertex
+    {
+        khepri::Vector3f position;   ///< Position (in object space)
+        std::int16_t     normal[2];  ///< Octahedral-encoded normal vector
+        std::int16_t     tangent[2]; ///< Octahedral-encoded tangent vector and binormal sign
+        std::uint16_t    uv[4][2];   ///< Texture coordinates, as half-precision floats
+        std::uint8_t     color[4];   ///< Color (in linear color space), 8 bits per component
+    };
+
+    /// The format in which a model's vertices are stored
+    enum class VertexFormat
+    {
+        /// Every vertex is stored as a Vertex
+        full,
+
+        /// Every vertex is stored as a CompactVertex
+        compact,
+    };
+
     /**
      * Description of a material part of a mesh.
      * A mesh is split into one or more "sub-meshes", each for a specific material.
@@ -51,19 +79,23 @@ public:
         /// A material parameter
         struct Param
         {
-            std::string name;  ///< The parameter's name
-            ParamValue  value; ///< The parameter's value
+            Symbol     name;  ///< The parameter's name
+            ParamValue value; ///< The parameter's value
         };
 
         /// The material's name
-        std::string name;
+        Symbol name;
 
         /// The material's parameters
         std::vector<Param> params;
 
-        /// The mesh's vertices for this material
+        /// The mesh's vertices for this material, in full form
         std::vector<Vertex> vertices;
 
+        /// The mesh's vertices for this material, in compact form. If not empty, this is used
+        /// instead of #vertices.
+        std::vector<CompactVertex> compact_vertices;
+
         /// The mesh's vertex indices for this material
         std::vector<Index> indices;
     };
@@ -78,7 +110,7 @@ public:
         /**
          * @brief The meshes' name
          */
-        std::string name;
+        Symbol name;
 
         /**
          * @brief The mesh's LoD (level-of-detail) level.
@@ -109,6 +141,11 @@ public:
          */
         bool visible;
 
+        /**
+         * @brief The mesh's bounding box (in object space)
+         */
+        BoundingBox bounding_box;
+
         /**
          * @brief The materials of the mesh
          *
@@ -1,11 +1,19 @@
 #pragma once
 
+#include "material_info.hpp"
 #include "model.hpp"
 #include "render_model.hpp"
 
 #include <khepri/io/exceptions.hpp>
 #include <khepri/log/log.hpp>
 #include <khepri/renderer/renderer.hpp>
+#include <openglyph/utility/thread_pool.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace openglyph::renderer {
 
@@ -15,16 +23,194 @@ public:
     template <typename T>
     using Loader = std::function<T*(std::string_view)>;
 
-    ModelCreator(khepri::renderer::Renderer&        renderer,
-                 Loader<khepri::renderer::Material> material_loader,
-                 Loader<khepri::renderer::Texture>  texture_loader);
+    /// Loads a material by name
+    using MaterialLoader = std::function<khepri::renderer::Material*(Symbol)>;
+
+    /// Loads the information of a material by name
+    using MaterialInfoLoader = std::function<const MaterialInfo*(Symbol)>;
+
+    /**
+     * Constructs the model creator.
+     *
+     * @param material_info_loader optional loader for the information of materials. With it,
+     *                             material parameters are bound to shader property slots and
+     *                             meshes are sorted by their material's state; without it,
+     *                             parameters are passed on as-is and meshes are only sorted by
+     *                             mesh and depth.
+     */
+    ModelCreator(khepri::renderer::Renderer&       renderer, MaterialLoader material_loader,
+                 Loader<khepri::renderer::Texture> texture_loader,
+                 MaterialInfoLoader                material_info_loader = {});
+
+    /// A mesh of a render model that was created without a renderable mesh
+    struct DeferredMesh
+    {
+        std::size_t  mesh;     ///< Index of the mesh in the render model
+        std::size_t  source;   ///< Index of the mesh's source in Model::meshes
+        unsigned int lod;      ///< The mesh's LoD level
+        bool         occluder; ///< Whether the mesh's geometry belongs in the model's occluder
+    };
 
     std::unique_ptr<RenderModel> create_model(const Model& model);
 
+    /**
+     * Creates a render model whose more detailed meshes are created later.
+     *
+     * Only the least detailed LoD variant of every mesh gets its renderable mesh. The other
+     * variants are created without one, so their materials in @a model only need a name and
+     * parameters. They are not drawn until their renderable mesh is created with
+     * #create_deferred_mesh(); until then, the most detailed resident variant is drawn instead.
+     *
+     * The model's occluder lacks the geometry of the deferred meshes that belong in it (see
+     * DeferredMesh::occluder). It is complete once that is added with #add_to_occluder().
+     *
+     * @param model the model to create
+     * @param deferred receives the meshes that were created without a renderable mesh
+     */
+    std::unique_ptr<RenderModel> create_model(const Model&               model,
+                                              std::vector<DeferredMesh>& deferred);
+
+    /**
+     * Creates the description of the renderable mesh of a material.
+     *
+     * This does not use the model creator's state, so it may be called from any thread.
+     */
+    static khepri::renderer::MeshDesc create_mesh_desc(const Model::Material& material);
+
+    /**
+     * Adds the geometry of a material to a model's occluder.
+     *
+     * @return false if the occluder would become too large to rasterize; it is left unchanged.
+     */
+    static bool add_to_occluder(RenderModel::Occluder& occluder, const Model::Material& material);
+
+    /**
+     * Enables or disables merging of static meshes.
+     *
+     * When enabled, meshes of a model that are always drawn — visible, without LoD or Alt
+     * variants and with a single material — are merged into one mesh if they share the material
+     * and its parameters. This reduces the number of draw calls for models with many small
+     * meshes. A merged mesh has the name of its first mesh; the other meshes no longer exist in
+     * the render model, so they can't be addressed by index or name. Disabled by default.
+     */
+    void merge_static_meshes(bool enabled) noexcept
+    {
+        m_merge_static_meshes = enabled;
+    }
+
+    /**
+     * Creates a renderable mesh.
+     *
+     * If mesh deduplication is enabled and a mesh with the same contents was created before and
+     * is still in use, that mesh is returned instead.
+     */
+    std::shared_ptr<khepri::renderer::Mesh> create_mesh(const khepri::renderer::MeshDesc& desc);
+
+    /**
+     * Creates the renderable mesh of a mesh that was created without one, and sets it (see
+     * RenderModel::render_mesh()).
+     *
+     * Like the meshes that are created with their model, the mesh's sort key refers to its
+     * renderable mesh, which may be shared (see #deduplicate_meshes()).
+     *
+     * @param model the model of the mesh
+     * @param mesh the index of the mesh in @a model (see DeferredMesh::mesh)
+     * @param desc the contents of the mesh
+     */
+    void create_deferred_mesh(RenderModel& model, std::size_t mesh,
+                              const khepri::renderer::MeshDesc& desc);
+
+    /**
+     * Enables or disables deduplication of renderable meshes.
+     *
+     * When enabled, the creator keeps a registry of the meshes it created. Meshes with the same
+     * contents, e.g. parts that several models have in common, then share one renderable mesh for
+     * as long as any model uses it, and their instances are sorted together. Meshes are looked up
+     * by a hash of their vertices and indices, and a match is confirmed by a second hash that is
+     * computed differently, so no copy of the contents is kept. This saves GPU memory and upload
+     * time. Disabled by default.
+     */
+    void deduplicate_meshes(bool enabled) noexcept
+    {
+        m_deduplicate_meshes = enabled;
+    }
+
+    /// Returns the number of mesh creations that were avoided by deduplication
+    [[nodiscard]] std::size_t deduplicated_meshes() const noexcept
+    {
+        return m_deduplicated_meshes;
+    }
+
+    /// Returns the number of bytes of vertex and index data that were not uploaded because of
+    /// deduplication
+    [[nodiscard]] std::size_t deduplicated_bytes() const noexcept
+    {
+        return m_deduplicated_bytes;
+    }
+
+    /**
+     * Sets the thread pool to convert meshes on.
+     *
+     * With a pool, the vertices and material parameters of all meshes of a model are converted
+     * in parallel. The loaders and the renderer are still only called from the calling thread,
+     * in the same order as without a pool. Pass nullptr to convert meshes on the calling thread.
+     */
+    void thread_pool(ThreadPool* thread_pool) noexcept
+    {
+        m_thread_pool = thread_pool;
+    }
+
+    /// Returns the thread pool to convert meshes on, if any
+    [[nodiscard]] ThreadPool* thread_pool() const noexcept
+    {
+        return m_thread_pool;
+    }
+
 private:
+    // A mesh created with deduplication. Its entry's key is one hash of its contents; this holds
+    // the other.
+    struct SharedMesh
+    {
+        std::uint64_t                         check;
+        std::uint32_t                         index; // Index of the mesh in sort keys
+        std::weak_ptr<khepri::renderer::Mesh> mesh;
+    };
+
+    // Creates a renderable mesh like create_mesh(), and returns its index for sort keys
+    std::shared_ptr<khepri::renderer::Mesh> create_mesh(const khepri::renderer::MeshDesc& desc,
+                                                        std::uint32_t& mesh_index);
+
+    // Removes the entries of meshes that are no longer used
+    void prune_meshes();
+
+    static constexpr std::size_t MIN_MESHES_PRUNE_SIZE = 64;
+
+    // Returns the name of the material that a mesh's material refers to: its base name
+    Symbol material_name(Symbol mesh_material);
+
+    std::unique_ptr<RenderModel> create_render_model(const Model&               model,
+                                                     std::vector<DeferredMesh>* deferred);
+
     khepri::renderer::Renderer&        m_renderer;
-    Loader<khepri::renderer::Material> m_material_loader;
+    MaterialLoader                     m_material_loader;
     Loader<khepri::renderer::Texture>  m_texture_loader;
+    MaterialInfoLoader                 m_material_info_loader;
+    ThreadPool*                        m_thread_pool{nullptr};
+    std::uint32_t                      m_next_mesh_index{0};
+    bool                               m_merge_static_meshes{false};
+    bool                               m_deduplicate_meshes{false};
+
+    // Material name of every mesh material name seen so far, see material_name()
+    std::unordered_map<Symbol, Symbol> m_material_names;
+
+    // Meshes created with deduplication, by key hash of their contents. Entries of meshes that are
+    // no longer used are pruned when the registry has doubled in size since the last pruning.
+    std::unordered_multimap<std::uint64_t, SharedMesh> m_meshes;
+    std::size_t                                        m_meshes_prune_size{MIN_MESHES_PRUNE_SIZE};
+
+    // Totals of the meshes that were shared instead of created
+    std::size_t m_deduplicated_meshes{0};
+    std::size_t m_deduplicated_bytes{0};
 };
 
 } // namespace openglyph::renderer
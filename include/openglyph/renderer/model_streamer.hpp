@@ -0,0 +1,140 @@
+#pragma once
+
+#include "model_creator.hpp"
+#include "render_model.hpp"
+
+#include <khepri/io/stream.hpp>
+#include <khepri/renderer/mesh_desc.hpp>
+#include <openglyph/renderer/io/model.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace openglyph::renderer {
+
+/**
+ * @brief Loads models progressively, from low to high level of detail.
+ *
+ * A model loaded through the streamer is created right away with only the least detailed LoD
+ * variant of every mesh (see ModelCreator::create_model()), so it can be drawn on the next frame.
+ * The more detailed variants are decoded in the background, one LoD level at a time, and their
+ * renderable meshes are created on #update(). Until then, objects with the model draw the most
+ * detailed variant that is resident. The model's occluder (see RenderModel::occluder()) is
+ * completed when its last mesh becomes resident.
+ *
+ * Decoding runs on the model creator's thread pool (see ModelCreator::thread_pool()). Without a
+ * pool, LoD levels are decoded on the thread that calls #update().
+ *
+ * Models are streamed in the order they were loaded.
+ */
+class ModelStreamer final
+{
+public:
+    /// Opens a model by name
+    using StreamLoader = std::function<std::unique_ptr<khepri::io::Stream>(std::string_view)>;
+
+    /// Settings of the model streamer
+    struct Options
+    {
+        /// Maximum number of LoD levels that are decoded in the background at the same time
+        std::size_t max_pending_loads{4};
+    };
+
+    ModelStreamer(ModelCreator& model_creator, StreamLoader loader, const Options& options);
+
+    ModelStreamer(const ModelStreamer&) = delete;
+    ModelStreamer& operator=(const ModelStreamer&) = delete;
+    ~ModelStreamer();
+
+    /**
+     * @brief Loads a model and creates the least detailed variants of its meshes.
+     *
+     * The caller owns the returned model. It must keep the model alive while the model is
+     * streamed, or call #cancel() before destroying it. Models without LoD variants are returned
+     * complete.
+     *
+     * @return the model, or nullptr if the model could not be opened.
+     * @throws khepri::io::Error if the model is not valid.
+     */
+    std::unique_ptr<RenderModel> load(std::string_view name);
+
+    /**
+     * @brief Makes decoded LoD levels resident and starts decoding the next ones.
+     *
+     * This creates the renderable meshes of the decoded levels, so it must not be called while a
+     * model of the streamer is rendered.
+     */
+    void update();
+
+    /**
+     * @brief Stops streaming a model.
+     *
+     * The model's meshes that are not resident yet stay that way. Afterwards, the streamer no
+     * longer accesses the model, so it may be destroyed. Does nothing if the model is not
+     * streamed.
+     */
+    void cancel(const RenderModel& model) noexcept;
+
+    /// Returns a counter that changes every time meshes of any model become resident
+    [[nodiscard]] std::uint64_t generation() const noexcept
+    {
+        return m_generation;
+    }
+
+    /// Returns the number of models that still have meshes to stream
+    [[nodiscard]] std::size_t streaming_count() const noexcept
+    {
+        return m_entries.size();
+    }
+
+private:
+    using MeshDescs = std::vector<std::pair<std::size_t, khepri::renderer::MeshDesc>>;
+
+    struct Entry
+    {
+        std::string name;
+
+        // The streamed model; null if streaming was canceled
+        RenderModel*                              model{nullptr};
+        std::vector<std::uint8_t>                 data;
+        std::unique_ptr<openglyph::io::ModelView> view;
+
+        // The meshes that are not resident or pending yet, ordered by LoD level
+        std::vector<ModelCreator::DeferredMesh> meshes;
+        bool                                    pending{false};
+
+        // The sources of the deferred meshes that are added to the occluder once all are resident
+        std::vector<std::size_t> occluder_sources;
+    };
+
+    struct PendingLoad
+    {
+        Entry*                 entry;
+        std::future<MeshDescs> result;
+    };
+
+    void complete_loads();
+    void complete_occluder(Entry& entry);
+    void remove_done_entries() noexcept;
+    void start_loads();
+    void start_load(Entry& entry);
+
+    ModelCreator& m_model_creator;
+    StreamLoader  m_loader;
+    Options       m_options;
+
+    // Entries are only accessed through pending loads while they are pending, so they are
+    // destroyed after the pending loads have finished. The destructor waits for them.
+    std::vector<std::unique_ptr<Entry>> m_entries;
+    std::vector<PendingLoad>            m_pending;
+    std::uint64_t                       m_generation{0};
+};
+
+} // namespace openglyph::renderer
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "bounding_box.hpp"
+
+#include <gsl/gsl-lite.hpp>
+#include <khepri/math/matrix.hpp>
+#include <khepri/math/vector3.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace openglyph::renderer {
+
+/**
+ * @brief Settings for occlusion culling.
+ */
+struct OcclusionSettings
+{
+    /// Width of the depth buffer, in pixels; rounded up to a multiple of 4
+    unsigned int width{256};
+
+    /// Height of the depth buffer, in pixels
+    unsigned int height{128};
+
+    /// Minimum size of an occluder on screen, relative to the screen height (see LodSettings).
+    /// Objects that are drawn with reduced detail are never used as occluders.
+    float min_occluder_size{0.1f};
+
+    /// Maximum number of occluders per frame. The objects that are largest on screen are used.
+    std::size_t max_occluders{16};
+};
+
+/**
+ * @brief Low-resolution depth buffer for occlusion culling on the CPU.
+ *
+ * Every frame, the buffer is cleared for the camera and a few large occluders are rasterized into
+ * it. Objects can then be tested against the buffer: an object whose bounds are behind the
+ * occluders at every pixel they cover is hidden and need not be drawn.
+ *
+ * The buffer stores the view-space depth of the occluders. To keep the test conservative, every
+ * occluder triangle is rasterized at the depth of its farthest vertex, and occluder triangles
+ * that cross the near plane are skipped. Pixels are processed four at a time with SSE where
+ * available.
+ *
+ * The buffer does not depend on a renderer, so it can be used headless.
+ */
+class OcclusionBuffer final
+{
+public:
+    /**
+     * Constructs an occlusion buffer.
+     *
+     * @param width the width of the buffer, in pixels; rounded up to a multiple of 4
+     * @param height the height of the buffer, in pixels
+     *
+     * @throw std::invalid_argument if @a width or @a height is zero
+     */
+    OcclusionBuffer(unsigned int width, unsigned int height);
+
+    /// Returns the width of the buffer, in pixels
+    [[nodiscard]] unsigned int width() const noexcept
+    {
+        return m_width;
+    }
+
+    /// Returns the height of the buffer, in pixels
+    [[nodiscard]] unsigned int height() const noexcept
+    {
+        return m_height;
+    }
+
+    /// Returns the view-space depth of every pixel, row by row; infinity where nothing is drawn
+    [[nodiscard]] gsl::span<const float> depths() const noexcept
+    {
+        return m_depths;
+    }
+
+    /**
+     * Clears the buffer and sets up the camera for the next occluders and tests.
+     *
+     * @param view_proj the camera's combined view and projection matrix
+     */
+    void clear(const khepri::Matrixf& view_proj);
+
+    /**
+     * Rasterizes an occluder into the buffer.
+     *
+     * @param vertices the occluder's vertices, in object space
+     * @param indices the vertex indices of the occluder's triangles
+     * @param transform the object's world transform
+     */
+    void add_occluder(gsl::span<const khepri::Vector3f> vertices,
+                      gsl::span<const std::uint32_t> indices, const khepri::Matrixf& transform);
+
+    /**
+     * Tests if an object is possibly visible.
+     *
+     * @param box the object's bounds, in object space
+     * @param transform the object's world transform
+     *
+     * @return false if the box is behind the occluders at every pixel it covers.
+     */
+    [[nodiscard]] bool is_visible(const BoundingBox& box, const khepri::Matrixf& transform) const;
+
+private:
+    // Coefficients for computing every clip-space coordinate from (x, y, z, 1)
+    using Rows = std::array<std::array<float, 4>, 4>;
+
+    // A vertex in screen space, with its view-space depth
+    struct ScreenVertex
+    {
+        float x;
+        float y;
+        float depth;
+    };
+
+    Rows         to_clip(const khepri::Matrixf& transform) const noexcept;
+    ScreenVertex to_screen(const Rows& rows, const khepri::Vector3f& v) const noexcept;
+    void rasterize(ScreenVertex v0, ScreenVertex v1, ScreenVertex v2) noexcept;
+
+    unsigned int       m_width;
+    unsigned int       m_height;
+    std::vector<float> m_depths;
+
+    Rows m_view_proj{};
+
+    // Vertices of the current occluder in screen space, kept to avoid reallocation
+    std::vector<ScreenVertex> m_screen_vertices;
+};
+
+} // namespace openglyph::renderer
@@ -1,9 +1,18 @@
 #pragma once
 
+#include "bounding_box.hpp"
+#include "material_info.hpp"
+
 #include <khepri/renderer/material.hpp>
 #include <khepri/renderer/mesh.hpp>
 #include <khepri/renderer/mesh_instance.hpp>
+#include <openglyph/utility/symbol.hpp>
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
 #include <vector>
 
 namespace openglyph::renderer {
@@ -15,22 +24,129 @@ public:
     {
         using Param = khepri::renderer::Material::Param;
 
-        std::string                             name;
-        std::unique_ptr<khepri::renderer::Mesh> render_mesh;
+        Symbol                                  name;
+        unsigned int                            lod;
+        unsigned int                            alt;
+
+        /// The renderable mesh. Models with identical meshes may share it (see
+        /// ModelCreator::deduplicate_meshes()).
+        std::shared_ptr<khepri::renderer::Mesh> render_mesh;
         khepri::renderer::Material*             material;
-        std::vector<Param>                      material_params;
-        bool                                    visible;
+
+        /// Information about the material, if known
+        const MaterialInfo* material_info{nullptr};
+
+        /// Material parameters. If the material is known, these are sorted by slot, followed by
+        /// the parameters that the material's properties don't list, in file order.
+        std::vector<Param> material_params;
+
+        /// Shader property slot of each material parameter; empty if the material is not known.
+        /// Parameters that the material's properties don't list have MaterialInfo::NO_SLOT.
+        /// Slots are only used by instanced submission; Renderer::render_meshes() matches all
+        /// parameters by name.
+        std::vector<std::uint32_t> param_slots;
+
+        bool        visible;
+        BoundingBox bounding_box;
+
+        /// Sort key of the mesh's draw state, without depth (see SortKey)
+        std::uint64_t sort_key{0};
+    };
+
+    /**
+     * A group of meshes that are LoD variants of each other: meshes with the same name and Alt
+     * level. Only one mesh of a group is drawn at a time.
+     */
+    struct LodGroup
+    {
+        /// Indices of the meshes in the group, from lowest to highest LoD level (detail)
+        std::vector<std::size_t> meshes;
+
+        /// Number of meshes, from the lowest LoD level, that have a renderable mesh. Meshes of a
+        /// streamed model get their renderable mesh later (see #render_mesh()).
+        std::size_t resident{0};
+
+        /// Returns the index of the mesh to draw when reducing detail by @a reduction levels.
+        /// If that mesh is not resident yet, the most detailed resident mesh is returned.
+        [[nodiscard]] std::size_t select(unsigned int reduction) const noexcept
+        {
+            const auto top   = meshes.size() - 1;
+            const auto level = top - std::min<std::size_t>(reduction, top);
+            return meshes[std::min(level, std::max<std::size_t>(resident, 1) - 1)];
+        }
     };
 
-    explicit RenderModel(std::vector<Mesh> meshes) : m_meshes(std::move(meshes)) {}
+    /**
+     * Simplified geometry of the model for occlusion culling, in object space.
+     *
+     * The triangles must lie within the model's visible surface, so that anything they hide is
+     * also hidden by the model. The occluder is built from the most detailed variant of the
+     * model's meshes, so it only holds for objects that draw that variant.
+     */
+    struct Occluder
+    {
+        std::vector<khepri::Vector3f> vertices;
+        std::vector<std::uint32_t>    indices;
+    };
+
+    explicit RenderModel(std::vector<Mesh> meshes, Occluder occluder = {});
 
     const auto& meshes() const noexcept
     {
         return m_meshes;
     }
 
+    /// The bounding box of all meshes of the model (in object space)
+    const BoundingBox& bounding_box() const noexcept
+    {
+        return m_bounding_box;
+    }
+
+    /// The LoD groups of the model, in order of their first mesh. Every mesh is in one group.
+    const auto& lod_groups() const noexcept
+    {
+        return m_lod_groups;
+    }
+
+    /// The occluder geometry of the model; empty if the model is not used as occluder
+    const Occluder& occluder() const noexcept
+    {
+        return m_occluder;
+    }
+
+    /**
+     * Replaces the occluder geometry of the model, e.g. once the meshes it is built from are
+     * resident. This must not be called while the model is rendered.
+     */
+    void occluder(Occluder occluder) noexcept
+    {
+        m_occluder = std::move(occluder);
+    }
+
+    /// Returns true if any mesh of the model has multiple LoD variants
+    [[nodiscard]] bool has_lods() const noexcept
+    {
+        return m_lod_groups.size() != m_meshes.size();
+    }
+
+    /**
+     * Sets the renderable mesh of a mesh that was created without one, and its sort key.
+     *
+     * The mesh is drawn from then on, if it is selected. Meshes must be made resident in order
+     * of their LoD level, from low to high. This must not be called while the model is rendered.
+     * See ModelCreator::create_deferred_mesh().
+     */
+    void render_mesh(std::size_t mesh, std::shared_ptr<khepri::renderer::Mesh> render_mesh,
+                     std::uint64_t sort_key);
+
 private:
-    std::vector<Mesh> m_meshes;
+    // Counts the meshes of a LoD group that are resident
+    void update_residency(LodGroup& group) const noexcept;
+
+    std::vector<Mesh>     m_meshes;
+    BoundingBox           m_bounding_box;
+    std::vector<LodGroup> m_lod_groups;
+    Occluder              m_occluder;
 };
 
 } // namespace openglyph::renderer
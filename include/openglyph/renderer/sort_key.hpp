@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+namespace openglyph::renderer {
+
+/**
+ * @brief Properties of a material that determine the order in which it's drawn.
+ */
+struct MaterialSortInfo
+{
+    /// Whether the material is alpha blended
+    bool translucent{false};
+
+    /// Index of the material's shader; materials with the same shader have the same index
+    std::uint32_t shader_index{0};
+
+    /// Index of the material
+    std::uint32_t material_index{0};
+};
+
+/**
+ * @brief 64-bit key that orders mesh instances to minimize render state changes.
+ *
+ * Opaque instances are drawn before translucent ones. Opaque instances are grouped by shader,
+ * material and mesh, and are drawn front-to-back within each group. Translucent instances must be
+ * drawn back-to-front, so for those the depth is the most significant part, followed by shader,
+ * material and mesh:
+ *
+ * @verbatim
+ *   opaque:      | 0 | shader (10) | material (14) | mesh (15)   | depth (24)  |
+ *   translucent: | 1 | ~depth (24) | shader (10)   | material (14) | mesh (15) |
+ * @endverbatim
+ *
+ * Indices that do not fit in their field wrap around. That merely makes the grouping less
+ * effective; translucent instances are still ordered by depth.
+ */
+class SortKey final
+{
+public:
+    static constexpr unsigned SHADER_BITS   = 10;
+    static constexpr unsigned MATERIAL_BITS = 14;
+    static constexpr unsigned MESH_BITS     = 15;
+    static constexpr unsigned DEPTH_BITS    = 24;
+
+    /// Creates the depth-less key of a mesh's draw state
+    static constexpr std::uint64_t create(const MaterialSortInfo& material,
+                                          std::uint32_t           mesh_index) noexcept
+    {
+        const auto state =
+            (((std::uint64_t{material.shader_index} & mask(SHADER_BITS)) << MATERIAL_BITS |
+              (material.material_index & mask(MATERIAL_BITS)))
+             << MESH_BITS) |
+            (mesh_index & mask(MESH_BITS));
+        return material.translucent ? (TRANSLUCENT_BIT | state) : (state << DEPTH_BITS);
+    }
+
+    /**
+     * Adds the depth to a key created with #create().
+     *
+     * @param key the depth-less key
+     * @param distance_sq the squared distance from the camera to the instance
+     */
+    static std::uint64_t with_depth(std::uint64_t key, float distance_sq) noexcept
+    {
+        // The bit pattern of a non-negative float increases monotonically with its value, and
+        // its upper bits give a logarithmic quantization of the distance.
+        std::uint32_t bits = 0;
+        std::memcpy(&bits, &distance_sq, sizeof(bits));
+        const std::uint64_t depth = (distance_sq > 0 ? bits >> (31 - DEPTH_BITS) : 0);
+        if ((key & TRANSLUCENT_BIT) != 0) {
+            return key | ((~depth & mask(DEPTH_BITS)) << (SHADER_BITS + MATERIAL_BITS + MESH_BITS));
+        }
+        return key | depth;
+    }
+
+private:
+    static constexpr std::uint64_t TRANSLUCENT_BIT = std::uint64_t{1} << 63;
+
+    static constexpr std::uint64_t mask(unsigned bits) noexcept
+    {
+        return (std::uint64_t{1} << bits) - 1;
+    }
+};
+
+static_assert(1 + SortKey::SHADER_BITS + SortKey::MATERIAL_BITS + SortKey::MESH_BITS +
+                  SortKey::DEPTH_BITS ==
+              64);
+
+} // namespace openglyph::renderer
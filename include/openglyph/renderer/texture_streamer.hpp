@@ -0,0 +1,179 @@
+#pragma once
+
+#include <khepri/io/stream.hpp>
+#include <khepri/renderer/renderer.hpp>
+#include <khepri/renderer/texture.hpp>
+#include <khepri/renderer/texture_desc.hpp>
+#include <openglyph/renderer/io/dds.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace openglyph::renderer {
+
+/**
+ * @brief Streams texture mip levels in and out based on their on-screen size.
+ *
+ * Textures loaded through the streamer are created as a "proxy" that only contains the smallest
+ * mip levels. The proxy is handed out to the caller and identifies the texture from then on.
+ * Only the layout of the texture and its smallest mip levels are read when the proxy is created;
+ * higher mip levels are read from the file on demand, without reading the levels that aren't
+ * needed. Streaming requires DDS textures; other textures are loaded fully.
+ *
+ * Each frame, the renderer reports the screen-space size at which each texture is used via
+ * #request(). On #update(), the higher mip levels of the most important textures are loaded in
+ * the background and, once loaded, replace the proxy. Use #resolve() to map a proxy onto the best
+ * texture that's currently resident.
+ *
+ * When the total size of resident mip levels exceeds the budget, the top mip levels of the
+ * least important textures are dropped again. The memory of a texture that's reloaded with fewer
+ * mip levels is only accounted as freed once the smaller texture has replaced it, whereas the
+ * memory of a texture that's loaded with more mip levels is accounted for from the moment its
+ * load starts.
+ *
+ * A texture whose higher mip levels fail to load is not streamed again; it keeps using its proxy.
+ */
+class TextureStreamer final
+{
+public:
+    /// Opens the file of a texture by name. This may be called from background threads.
+    using StreamLoader = std::function<std::unique_ptr<khepri::io::Stream>(std::string_view)>;
+
+    /// Settings of the texture streamer
+    struct Options
+    {
+        /// Number of smallest mip levels that are loaded immediately into the proxy texture
+        unsigned int proxy_mip_levels{4};
+
+        /// Maximum number of bytes of mip data (excluding proxies) that may be resident
+        std::size_t resident_budget{256ull * 1024 * 1024};
+
+        /// Height of the screen (in pixels) that relative screen-space sizes are mapped onto
+        float screen_height{1080};
+
+        /// Maximum number of textures that are loaded in the background at the same time
+        std::size_t max_pending_loads{4};
+    };
+
+    TextureStreamer(khepri::renderer::Renderer& renderer, StreamLoader loader,
+                    const Options& options);
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+    ~TextureStreamer();
+
+    /**
+     * @brief Loads a texture and creates its proxy.
+     *
+     * The caller owns the returned proxy and must either keep it alive for as long as the
+     * streamer is alive, or #unload() it before destroying it. Textures with too few mip levels
+     * to stream are returned fully loaded.
+     *
+     * @return the proxy texture, or nullptr if the texture could not be loaded.
+     */
+    std::unique_ptr<khepri::renderer::Texture> load(std::string_view name);
+
+    /**
+     * @brief Stops streaming a texture and releases its resident mip levels.
+     *
+     * Call this before destroying a proxy returned by #load(). Does nothing if @a texture is not
+     * a streamed texture.
+     */
+    void unload(const khepri::renderer::Texture* texture);
+
+    /**
+     * @brief Returns the best resident version of a texture.
+     *
+     * Returns @a texture itself if it is not a streamed texture or if no higher mip levels are
+     * resident.
+     */
+    khepri::renderer::Texture* resolve(khepri::renderer::Texture* texture) const noexcept;
+
+    /**
+     * @brief Reports the use of a texture for the current frame.
+     *
+     * @param texture the texture's proxy, as returned by #load().
+     * @param screen_size the size of the object using the texture, relative to the screen height.
+     */
+    void request(const khepri::renderer::Texture* texture, float screen_size) noexcept;
+
+    /**
+     * @brief Processes the requests of the past frame.
+     *
+     * Completes finished background loads, starts new loads for the textures that need higher
+     * mip levels, in order of on-screen size, and drops mip levels when over budget.
+     */
+    void update();
+
+    /**
+     * @brief Returns a counter that changes every time the result of #resolve() changes for any
+     * texture.
+     */
+    [[nodiscard]] std::uint64_t generation() const noexcept
+    {
+        return m_generation;
+    }
+
+    /// Returns the number of bytes of mip data (excluding proxies) that is currently resident
+    [[nodiscard]] std::size_t resident_size() const noexcept
+    {
+        return m_resident_size;
+    }
+
+private:
+    struct Entry
+    {
+        std::uint64_t                              id{0};
+        std::string                                name;
+        std::shared_ptr<const io::DdsLayout>       layout;
+        khepri::renderer::Texture*                 proxy{nullptr};
+        std::unique_ptr<khepri::renderer::Texture> resident;
+        std::vector<std::size_t>                   mip_sizes;
+        unsigned int                               proxy_top_mip{0};
+        unsigned int                               resident_top_mip{0};
+        unsigned int                               desired_top_mip{0};
+        float                                      priority{0};
+        bool                                       pending{false};
+        bool                                       failed{false};
+    };
+
+    struct PendingLoad
+    {
+        const khepri::renderer::Texture*           key;
+        std::uint64_t                              id;
+        unsigned int                               top_mip;
+        std::size_t                                shrink;
+        std::size_t                                growth;
+        std::future<khepri::renderer::TextureDesc> result;
+    };
+
+    std::size_t  size_from(const Entry& entry, unsigned int top_mip) const noexcept;
+    unsigned int desired_top_mip(const Entry& entry) const noexcept;
+    void         complete_loads();
+    void         enforce_budget();
+    void         start_loads();
+    void         start_load(const khepri::renderer::Texture* key, Entry& entry,
+                            unsigned int top_mip, std::size_t shrink, std::size_t growth);
+    void         release(Entry& entry);
+
+    khepri::renderer::Renderer& m_renderer;
+    StreamLoader                m_loader;
+    Options                     m_options;
+
+    std::unordered_map<const khepri::renderer::Texture*, Entry> m_entries;
+    std::vector<PendingLoad>                                     m_pending;
+    std::size_t                                                  m_resident_size{0};
+    std::size_t                                                  m_pending_shrink{0};
+    std::size_t                                                  m_pending_growth{0};
+    std::uint64_t                                                m_generation{0};
+    std::uint64_t                                                m_next_id{0};
+};
+
+} // namespace openglyph::renderer
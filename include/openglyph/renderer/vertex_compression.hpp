@@ -0,0 +1,35 @@
+#pragma once
+
+#include "model.hpp"
+
+#include <gsl/gsl-lite.hpp>
+
+namespace openglyph::renderer {
+
+/**
+ * Converts vertices to compact form.
+ *
+ * Normals and tangents are normalized and octahedral-encoded, texture coordinates are rounded to
+ * half precision and colors are clamped to [0, 1] and quantized to 8 bits. The binormal is
+ * reduced to its direction relative to the cross product of the normal and tangent.
+ *
+ * Vertices are converted four at a time with SSE2 where available.
+ *
+ * @param vertices the vertices to convert
+ * @param compact_vertices receives the converted vertices; must have the size of @a vertices
+ */
+void compress_vertices(gsl::span<const Model::Vertex>  vertices,
+                       gsl::span<Model::CompactVertex> compact_vertices) noexcept;
+
+/**
+ * Converts compact vertices back to full form.
+ *
+ * The normals, tangents and binormals of the result are unit vectors.
+ *
+ * @param compact_vertices the vertices to convert
+ * @param vertices receives the converted vertices; must have the size of @a compact_vertices
+ */
+void decompress_vertices(gsl::span<const Model::CompactVertex> compact_vertices,
+                         gsl::span<Model::Vertex>              vertices) noexcept;
+
+} // namespace openglyph::renderer
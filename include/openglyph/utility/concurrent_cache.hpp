@@ -0,0 +1,90 @@
+#pragma once
+
+#include <khepri/utility/string.hpp>
+
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace openglyph {
+
+/**
+ * @brief A thread-safe cache of owned objects.
+ *
+ * Like khepri::OwningCache, objects are created on first request via a loader and owned by the
+ * cache. Unlike khepri::OwningCache, #get() can be called from multiple threads concurrently: the
+ * loader runs outside the cache's lock, so different objects are loaded in parallel. Concurrent
+ * requests for the same object wait for the first request to finish loading it.
+ *
+ * @note object lookup is case insensitive.
+ */
+template <typename T>
+class ConcurrentCache final
+{
+public:
+    using Loader = std::function<std::unique_ptr<T>(std::string_view)>;
+
+    explicit ConcurrentCache(Loader loader) : m_loader(std::move(loader)) {}
+
+    ConcurrentCache(const ConcurrentCache&) = delete;
+    ConcurrentCache& operator=(const ConcurrentCache&) = delete;
+
+    /**
+     * @brief Returns the object with the specified id, loading it if necessary.
+     *
+     * @return the object, or nullptr if the loader could not load it.
+     */
+    T* get(std::string_view id)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (auto it = m_entries.find(id); it != m_entries.end()) {
+            auto& entry = it->second;
+            m_loaded.wait(lock, [&] { return entry.loaded; });
+            return entry.object.get();
+        }
+
+        auto& entry = m_entries[std::string(id)];
+        lock.unlock();
+
+        std::unique_ptr<T> object;
+        try {
+            object = m_loader(id);
+        } catch (...) {
+            // Don't leave other threads waiting on this entry
+            lock.lock();
+            entry.loaded = true;
+            m_loaded.notify_all();
+            throw;
+        }
+
+        lock.lock();
+        entry.object = std::move(object);
+        entry.loaded = true;
+        m_loaded.notify_all();
+        return entry.object.get();
+    }
+
+    auto as_loader()
+    {
+        return [this](std::string_view id) { return this->get(id); };
+    }
+
+private:
+    struct Entry
+    {
+        std::unique_ptr<T> object;
+        bool               loaded{false};
+    };
+
+    Loader                  m_loader;
+    std::mutex              m_mutex;
+    std::condition_variable m_loaded;
+
+    std::map<std::string, Entry, khepri::CaseInsensitiveLess> m_entries;
+};
+
+} // namespace openglyph
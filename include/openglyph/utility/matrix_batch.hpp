@@ -0,0 +1,23 @@
+#pragma once
+
+#include <gsl/gsl-lite.hpp>
+#include <khepri/math/matrix.hpp>
+
+namespace openglyph {
+
+/**
+ * @brief Multiplies matrices pairwise: <tt>result[i] = lhs[i] * rhs[i]</tt>.
+ *
+ * The matrices are processed four at a time in structure-of-arrays form: every SIMD register
+ * holds the same element of four matrices, so each 4x4 multiply becomes 64 vectorized
+ * multiply-adds for four products. Remaining matrices, and builds without SSE, use a scalar
+ * implementation.
+ *
+ * The result may not overlap with the inputs.
+ *
+ * @throw std::invalid_argument if the spans do not have the same size
+ */
+void multiply_batch(gsl::span<const khepri::Matrixf> lhs, gsl::span<const khepri::Matrixf> rhs,
+                    gsl::span<khepri::Matrixf> result);
+
+} // namespace openglyph
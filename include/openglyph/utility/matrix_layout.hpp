@@ -0,0 +1,47 @@
+#pragma once
+
+#include <khepri/math/matrix.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+namespace openglyph {
+
+static_assert(sizeof(khepri::Matrixf) == 16 * sizeof(float));
+
+/**
+ * @brief Returns the elements of a matrix, in memory order.
+ *
+ * A khepri::Matrixf is 16 floats in row-major order that transforms row vectors:
+ * <tt>v' = v * M</tt>. Output coordinate @a i of a transform is thus
+ * <tt>sum(v[k] * m[k * 4 + i])</tt>, i.e. it is produced by column @a i of the matrix, and a
+ * translation is stored in elements 12 to 14. Code that reads the elements of matrices relies on
+ * this layout only through this function and #transform_coefficients().
+ */
+inline std::array<float, 16> matrix_elements(const khepri::Matrixf& matrix) noexcept
+{
+    std::array<float, 16> elements{};
+    std::memcpy(elements.data(), &matrix, sizeof(elements));
+    return elements;
+}
+
+/**
+ * @brief Returns the coefficients that produce each output coordinate of a transform.
+ *
+ * Output coordinate @a i of (x, y, z, w) is <tt>dot(coefficients[i], (x, y, z, w))</tt>.
+ */
+inline std::array<std::array<float, 4>, 4>
+transform_coefficients(const khepri::Matrixf& matrix) noexcept
+{
+    const auto                          m = matrix_elements(matrix);
+    std::array<std::array<float, 4>, 4> coefficients{};
+    for (std::size_t i = 0; i < 4; ++i) {
+        for (std::size_t k = 0; k < 4; ++k) {
+            coefficients[i][k] = m[k * 4 + i];
+        }
+    }
+    return coefficients;
+}
+
+} // namespace openglyph
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace openglyph {
+
+/**
+ * @brief Sorts key/value pairs by their 64-bit key.
+ *
+ * This is a stable least-significant-digit radix sort with 8-bit digits. The histograms of all
+ * digits are built in a single pass, and passes for digits that are identical for all keys are
+ * skipped, so keys that only use a few bits are sorted in a few passes.
+ *
+ * @param items the items to sort.
+ * @param scratch scratch buffer. Its contents are undefined afterwards; pass the same buffer on
+ *                every call to avoid allocations.
+ */
+template <typename T>
+void radix_sort(std::vector<std::pair<std::uint64_t, T>>& items,
+                std::vector<std::pair<std::uint64_t, T>>& scratch)
+{
+    constexpr std::size_t DIGIT_BITS = 8;
+    constexpr std::size_t NUM_DIGITS = 64 / DIGIT_BITS;
+    constexpr std::size_t RADIX      = std::size_t{1} << DIGIT_BITS;
+
+    std::array<std::array<std::size_t, RADIX>, NUM_DIGITS> counts{};
+    for (const auto& item : items) {
+        for (std::size_t d = 0; d < NUM_DIGITS; ++d) {
+            ++counts[d][(item.first >> (d * DIGIT_BITS)) & (RADIX - 1)];
+        }
+    }
+
+    scratch.resize(items.size());
+    for (std::size_t d = 0; d < NUM_DIGITS; ++d) {
+        auto& count = counts[d];
+        if (items.empty() || count[(items.front().first >> (d * DIGIT_BITS)) & (RADIX - 1)] ==
+                                 items.size()) {
+            // All keys have the same digit
+            continue;
+        }
+
+        // Turn the counts into offsets and scatter the items
+        std::size_t offset = 0;
+        for (auto& c : count) {
+            offset += std::exchange(c, offset);
+        }
+        for (auto& item : items) {
+            scratch[count[(item.first >> (d * DIGIT_BITS)) & (RADIX - 1)]++] = std::move(item);
+        }
+        items.swap(scratch);
+    }
+}
+
+} // namespace openglyph
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string_view>
+
+namespace openglyph {
+
+/**
+ * @brief An interned, case-insensitive name.
+ *
+ * Symbols are stored once in a global, thread-safe table and are represented by a 32-bit ID.
+ * Strings that only differ in (ASCII) case intern to the same symbol, so comparing two symbols is
+ * a case-insensitive string comparison at the cost of an integer comparison.
+ *
+ * The table also stores the case-folded hash of every symbol, so hashing a symbol is free.
+ *
+ * Interned strings are never released. The spelling of a symbol is the spelling it was first
+ * interned with.
+ */
+class Symbol final
+{
+public:
+    /// Type of a symbol's ID
+    using Id = std::uint32_t;
+
+    /// Constructs the empty symbol
+    constexpr Symbol() noexcept = default;
+
+    /// Interns @a str and constructs its symbol
+    explicit Symbol(std::string_view str);
+
+    /**
+     * @brief Finds the symbol for a string without interning it.
+     *
+     * Returns @a std::nullopt if @a str has never been interned.
+     *
+     * @throws std::system_error if the symbol table could not be locked.
+     */
+    static std::optional<Symbol> find(std::string_view str);
+
+    /// Returns the symbol's ID. The empty symbol has ID 0.
+    [[nodiscard]] constexpr Id id() const noexcept
+    {
+        return m_id;
+    }
+
+    /// Returns true if this is the empty symbol
+    [[nodiscard]] constexpr bool empty() const noexcept
+    {
+        return m_id == 0;
+    }
+
+    /// Returns the symbol's string. The returned view is valid for the lifetime of the program.
+    [[nodiscard]] std::string_view str() const noexcept;
+
+    /// Returns the case-insensitive hash of the symbol's string
+    [[nodiscard]] std::uint32_t hash() const noexcept;
+
+    friend constexpr bool operator==(Symbol s1, Symbol s2) noexcept
+    {
+        return s1.m_id == s2.m_id;
+    }
+
+    friend constexpr bool operator!=(Symbol s1, Symbol s2) noexcept
+    {
+        return s1.m_id != s2.m_id;
+    }
+
+    /// Orders symbols by ID. This is @b not a lexicographical order.
+    friend constexpr bool operator<(Symbol s1, Symbol s2) noexcept
+    {
+        return s1.m_id < s2.m_id;
+    }
+
+private:
+    constexpr explicit Symbol(Id id) noexcept : m_id(id) {}
+
+    Id m_id{0};
+};
+
+} // namespace openglyph
+
+template <>
+struct std::hash<openglyph::Symbol>
+{
+    std::size_t operator()(openglyph::Symbol symbol) const noexcept
+    {
+        return symbol.hash();
+    }
+};
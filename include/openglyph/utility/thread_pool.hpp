@@ -0,0 +1,133 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace openglyph {
+
+/**
+ * @brief A pool of worker threads for data-parallel work.
+ *
+ * The pool runs one job at a time. A job is a number of independent tasks, identified by index,
+ * that are distributed over the worker threads and the calling thread.
+ *
+ * #parallel_for() may be called from multiple threads: concurrent jobs are run one after the
+ * other. A task may itself call #parallel_for() on the same pool; such a nested job is run
+ * entirely on the thread that runs the task, since the pool is still busy with the outer job.
+ *
+ * Independently of jobs, single tasks can be run in the background with #async().
+ */
+class ThreadPool final
+{
+public:
+    /**
+     * Constructs a thread pool.
+     *
+     * @param num_threads the total number of threads to run tasks on, including the calling
+     *                    thread. If zero, the number of hardware threads is used.
+     */
+    explicit ThreadPool(std::size_t num_threads = 0);
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ~ThreadPool();
+
+    /// Returns the total number of threads that run tasks, including the calling thread
+    [[nodiscard]] std::size_t size() const noexcept
+    {
+        return m_workers.size() + 1;
+    }
+
+    /**
+     * @brief Runs @a task for every index in [0, @a count) and waits until all have finished.
+     *
+     * Tasks may run in any order and on any thread. If any task throws, the remaining tasks are
+     * still run and the first exception is rethrown on the calling thread.
+     *
+     * If another thread is running a job on this pool, this call waits for that job to finish
+     * first. If called from a task of this pool, the tasks are run on the calling thread.
+     */
+    void parallel_for(std::size_t count, const std::function<void(std::size_t)>& task);
+
+    /**
+     * @brief Runs @a fn in the background on a worker thread.
+     *
+     * Background tasks are run in the order they were submitted, by worker threads that have no
+     * tasks of a job to run, so they delay a job by at most the workers they occupy. Without
+     * worker threads, @a fn is run on the calling thread before this returns.
+     *
+     * Background tasks that have not started when the pool is destroyed are abandoned; their
+     * futures then report std::future_errc::broken_promise.
+     *
+     * @return a future for the result of @a fn, or for the exception it threw
+     */
+    template <typename Fn>
+    std::future<std::invoke_result_t<Fn&>> async(Fn fn)
+    {
+        using Result = std::invoke_result_t<Fn&>;
+        auto task    = std::make_shared<std::packaged_task<Result()>>(std::move(fn));
+        auto result  = task->get_future();
+        enqueue([task] { (*task)(); });
+        return result;
+    }
+
+private:
+    void enqueue(std::function<void()> task);
+    void worker_main();
+    void run_tasks();
+
+    std::vector<std::thread> m_workers;
+
+    // Held for the duration of a job, to run the jobs of concurrent callers one at a time
+    std::mutex m_job_mutex;
+
+    std::mutex              m_mutex;
+    std::condition_variable m_work_available;
+    std::condition_variable m_work_done;
+    bool                    m_stop{false};
+
+    // The current job
+    const std::function<void(std::size_t)>* m_task{nullptr};
+    std::size_t                             m_count{0};
+    std::size_t                             m_next{0};
+    std::size_t                             m_active{0};
+    std::uint64_t                           m_job{0};
+    std::exception_ptr                      m_exception;
+
+    // Background tasks that have yet to start
+    std::deque<std::function<void()>> m_background_tasks;
+};
+
+/**
+ * @brief Runs @a fn(begin, end) over consecutive ranges that together cover [0, @a count).
+ *
+ * The ranges are processed in parallel on @a thread_pool if one is given and there is enough
+ * work; otherwise @a fn is called once for the whole range on the calling thread.
+ */
+template <typename Fn>
+void for_each_range(ThreadPool* thread_pool, std::size_t count, const Fn& fn)
+{
+    constexpr std::size_t MIN_RANGE_SIZE = 1024;
+    if (thread_pool == nullptr || count < 2 * MIN_RANGE_SIZE) {
+        fn(std::size_t{0}, count);
+        return;
+    }
+    const auto num_ranges = std::min(thread_pool->size() * 4, count / MIN_RANGE_SIZE);
+    thread_pool->parallel_for(num_ranges, [&](std::size_t range) {
+        fn(count * range / num_ranges, count * (range + 1) / num_ranges);
+    });
+}
+
+} // namespace openglyph
@@ -1,5 +1,5 @@
+#include <khepri/io/exceptions.hpp>
 #include <khepri/log/log.hpp>
-#include <khepri/renderer/io/shader.hpp>
 #include <khepri/renderer/io/texture.hpp>
 #include <openglyph/assets/asset_cache.hpp>
 #include <openglyph/renderer/io/material.hpp>
@@ -9,17 +9,12 @@ namespace openglyph {
 namespace {
 constexpr khepri::log::Logger LOG("assets");
 
-auto create_shader_loader(AssetLoader& asset_loader, khepri::renderer::Renderer& renderer)
+using TextureLoader = openglyph::renderer::ModelCreator::Loader<khepri::renderer::Texture>;
+
+auto create_shader_loader(ShaderSourceCache& shader_sources, khepri::renderer::Renderer& renderer)
 {
     return [&](std::string_view name) -> std::unique_ptr<khepri::renderer::Shader> {
-        const auto& shader_desc_loader =
-            [&](const std::filesystem::path& path) -> std::optional<khepri::renderer::ShaderDesc> {
-            if (auto stream = asset_loader.open_shader(path.string())) {
-                return khepri::renderer::io::load_shader(*stream);
-            }
-            return {};
-        };
-        return renderer.create_shader(name, shader_desc_loader);
+        return shader_sources.create_shader(renderer, name);
     };
 }
 
@@ -34,10 +29,60 @@ auto create_texture_loader(AssetLoader& asset_loader, khepri::renderer::Renderer
     };
 }
 
-auto create_render_model_loader(AssetLoader&                       asset_loader,
-                                openglyph::renderer::ModelCreator& model_creator)
+auto create_texture_stream_loader(AssetLoader& asset_loader)
+{
+    return [&](std::string_view name) { return asset_loader.open_texture(name); };
+}
+
+std::unique_ptr<openglyph::renderer::TextureStreamer>
+create_texture_streamer(AssetLoader& asset_loader, khepri::renderer::Renderer& renderer,
+                        const AssetCache::Options& options)
+{
+    if (options.texture_streaming) {
+        return std::make_unique<openglyph::renderer::TextureStreamer>(
+            renderer, create_texture_stream_loader(asset_loader), *options.texture_streaming);
+    }
+    return {};
+}
+
+auto create_streamed_texture_loader(openglyph::renderer::TextureStreamer*         texture_streamer,
+                                    std::vector<const khepri::renderer::Texture*>& textures)
+{
+    return [texture_streamer,
+            &textures](std::string_view name) -> std::unique_ptr<khepri::renderer::Texture> {
+        if (texture_streamer == nullptr) {
+            return {};
+        }
+        auto texture = texture_streamer->load(name);
+        if (texture) {
+            textures.push_back(texture.get());
+        }
+        return texture;
+    };
+}
+
+std::unique_ptr<openglyph::renderer::ModelStreamer>
+create_model_streamer(AssetLoader& asset_loader, openglyph::renderer::ModelCreator& model_creator,
+                      const AssetCache::Options& options)
+{
+    if (options.model_streaming) {
+        return std::make_unique<openglyph::renderer::ModelStreamer>(
+            model_creator,
+            [&asset_loader](std::string_view name) { return asset_loader.open_model(name); },
+            *options.model_streaming);
+    }
+    return {};
+}
+
+auto create_render_model_loader(AssetLoader&                        asset_loader,
+                                openglyph::renderer::ModelCreator&  model_creator,
+                                openglyph::renderer::ModelStreamer* model_streamer)
 {
-    return [&](std::string_view name) -> std::unique_ptr<openglyph::renderer::RenderModel> {
+    return [&, model_streamer](
+               std::string_view name) -> std::unique_ptr<openglyph::renderer::RenderModel> {
+        if (model_streamer != nullptr) {
+            return model_streamer->load(name);
+        }
         if (auto stream = asset_loader.open_model(name)) {
             const auto model = openglyph::io::read_model(*stream);
             return model_creator.create_model(model);
@@ -49,18 +94,58 @@ auto create_render_model_loader(AssetLoader&                       asset_loader,
 } // namespace
 
 AssetCache::AssetCache(AssetLoader& asset_loader, khepri::renderer::Renderer& renderer)
-    : m_shader_cache(create_shader_loader(asset_loader, renderer))
+    : AssetCache(asset_loader, renderer, Options{})
+{}
+
+AssetCache::AssetCache(AssetLoader& asset_loader, khepri::renderer::Renderer& renderer,
+                       const Options& options)
+    : m_shader_manifest(options.shader_manifest)
+    , m_shader_sources(asset_loader)
+    , m_shader_cache(create_shader_loader(m_shader_sources, renderer))
     , m_texture_cache(create_texture_loader(asset_loader, renderer))
-    , m_materials(renderer, m_shader_cache.as_loader(), m_texture_cache.as_loader())
-    , m_model_creator(renderer, m_materials.as_loader(), m_texture_cache.as_loader())
-    , m_render_model_cache(create_render_model_loader(asset_loader, m_model_creator))
+    , m_texture_streamer(create_texture_streamer(asset_loader, renderer, options))
+    , m_streamed_texture_cache(
+          create_streamed_texture_loader(m_texture_streamer.get(), m_streamed_textures))
+    , m_materials(renderer, m_shader_cache.as_loader(), m_texture_cache.as_loader(),
+                  options.material_mode)
+    , m_model_creator(renderer, m_materials.as_loader(),
+                      m_texture_streamer ? TextureLoader(m_streamed_texture_cache.as_loader())
+                                         : TextureLoader(m_texture_cache.as_loader()),
+                      m_materials.as_info_loader())
+    , m_model_streamer(create_model_streamer(asset_loader, m_model_creator, options))
+    , m_render_model_cache(
+          create_render_model_loader(asset_loader, m_model_creator, m_model_streamer.get()))
 {
+    // Registering the materials may already create their shaders
+    if (m_shader_manifest) {
+        m_shader_sources.load_manifest(*m_shader_manifest);
+    }
+    m_materials.thread_pool(options.material_thread_pool);
+    m_model_creator.thread_pool(options.model_thread_pool);
+    m_model_creator.deduplicate_meshes(options.deduplicate_meshes);
     if (auto stream = asset_loader.open_config("Materials")) {
         m_materials.register_materials(openglyph::renderer::io::load_materials(*stream));
     }
 }
 
-AssetCache::~AssetCache() = default;
+AssetCache::~AssetCache()
+{
+    // The streamed textures are destroyed before the streamer; release their entries, resident
+    // mip levels and pending loads while the textures are still alive.
+    if (m_texture_streamer) {
+        for (const auto* texture : m_streamed_textures) {
+            m_texture_streamer->unload(texture);
+        }
+    }
+
+    if (m_shader_manifest) {
+        try {
+            m_shader_sources.save_manifest(*m_shader_manifest);
+        } catch (const khepri::io::Error& e) {
+            LOG.error("{}", e.what());
+        }
+    }
+}
 
 khepri::renderer::Material* AssetCache::get_material(std::string_view name)
 {
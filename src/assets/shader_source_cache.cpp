@@ -0,0 +1,224 @@
+#include <khepri/io/exceptions.hpp>
+#include <khepri/log/log.hpp>
+#include <khepri/renderer/io/shader.hpp>
+#include <khepri/utility/string.hpp>
+#include <openglyph/assets/shader_source_cache.hpp>
+
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace openglyph {
+namespace {
+constexpr khepri::log::Logger LOG("assets");
+
+constexpr std::uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ull;
+constexpr std::uint64_t FNV_PRIME        = 0x100000001b3ull;
+
+// 64-bit FNV-1a hash
+std::uint64_t hash_bytes(const void* data, std::size_t size,
+                         std::uint64_t hash = FNV_OFFSET_BASIS) noexcept
+{
+    const auto* bytes = static_cast<const std::uint8_t*>(data);
+    for (std::size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+// Hashes the raw contents of a stream and rewinds it
+std::uint64_t hash_stream(khepri::io::Stream& stream)
+{
+    const auto size = stream.seek(0, khepri::io::SeekOrigin::end);
+    stream.seek(0, khepri::io::SeekOrigin::begin);
+    std::vector<std::uint8_t> data(static_cast<std::size_t>(size));
+    stream.read(data.data(), data.size());
+    stream.seek(0, khepri::io::SeekOrigin::begin);
+    return hash_bytes(data.data(), data.size());
+}
+
+// Adds a file of a shader to the shader's resolved hash
+std::uint64_t hash_resolved(std::uint64_t resolved_hash, const std::string& key,
+                            std::uint64_t file_hash) noexcept
+{
+    resolved_hash = hash_bytes(key.data(), key.size(), resolved_hash);
+    return hash_bytes(&file_hash, sizeof(file_hash), resolved_hash);
+}
+
+// Returns the key for a shader file: its lexically normalized, lowercase path
+std::string normalize(const fs::path& path)
+{
+    auto normalized = khepri::lowercase(path.lexically_normal().generic_string());
+    if (normalized.rfind("./", 0) == 0) {
+        normalized.erase(0, 2);
+    }
+    return normalized;
+}
+
+} // namespace
+
+ShaderSourceCache::~ShaderSourceCache() = default;
+
+const ShaderSourceCache::SourceFile& ShaderSourceCache::load(const fs::path& path)
+{
+    auto key = normalize(path);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (auto it = m_files.find(key); it != m_files.end()) {
+            return it->second;
+        }
+    }
+
+    // Load the file outside of the lock; if another thread loads the same file in the meantime,
+    // the first one to finish is kept.
+    SourceFile file;
+    if (auto stream = m_asset_loader.open_shader(path.string())) {
+        file.hash = hash_stream(*stream);
+        file.desc = khepri::renderer::io::load_shader(*stream);
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_files.emplace(std::move(key), std::move(file)).first->second;
+}
+
+const khepri::renderer::ShaderDesc* ShaderSourceCache::get(const fs::path& path)
+{
+    const auto& file = load(path);
+    return file.desc ? &*file.desc : nullptr;
+}
+
+std::unique_ptr<khepri::renderer::Shader>
+ShaderSourceCache::create_shader(khepri::renderer::Renderer& renderer, std::string_view name)
+{
+    // The renderer requests the shader file itself and then every file it includes, so the
+    // resolved hash covers the entire source that was compiled.
+    ResolvedShader resolved;
+    resolved.hash = FNV_OFFSET_BASIS;
+
+    const auto& shader_desc_loader =
+        [&](const fs::path& path) -> std::optional<khepri::renderer::ShaderDesc> {
+        const auto& file = load(path);
+        if (file.desc) {
+            auto key      = normalize(path);
+            resolved.hash = hash_resolved(resolved.hash, key, file.hash);
+            resolved.files.push_back(std::move(key));
+        }
+        return file.desc;
+    };
+
+    auto shader = renderer.create_shader(name, shader_desc_loader);
+    if (shader) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_resolved[normalize(name)] = std::move(resolved);
+    }
+    return shader;
+}
+
+std::optional<std::uint64_t> ShaderSourceCache::resolved_hash(std::string_view name) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (auto it = m_resolved.find(normalize(name)); it != m_resolved.end()) {
+        return it->second.hash;
+    }
+    return {};
+}
+
+bool ShaderSourceCache::unchanged(std::string_view name) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_unchanged.count(normalize(name)) != 0;
+}
+
+void ShaderSourceCache::load_manifest(const fs::path& path)
+{
+    std::ifstream file(path);
+    if (!file) {
+        return;
+    }
+
+    // Each shader is a line with its hexadecimal resolved hash, a space and its normalized name,
+    // followed by a line per resolved file: a tab and the file's normalized path.
+    std::map<std::string, ResolvedShader> manifest;
+    ResolvedShader*                       shader = nullptr;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        if (line[0] == '\t') {
+            if (shader != nullptr) {
+                shader->files.push_back(line.substr(1));
+            }
+            continue;
+        }
+        shader = nullptr;
+
+        std::istringstream iss(line);
+        std::uint64_t      hash = 0;
+        std::string        name;
+        if ((iss >> std::hex >> hash) && std::getline(iss >> std::ws, name) && !name.empty()) {
+            shader       = &manifest[name];
+            shader->hash = hash;
+        }
+    }
+
+    // Hash the files of the shaders as they are now, without parsing them. Shared include files
+    // are hashed once.
+    std::map<std::string, std::optional<std::uint64_t>> file_hashes;
+    std::map<std::string, ResolvedShader>               unchanged;
+    for (auto& [name, resolved] : manifest) {
+        std::uint64_t hash  = FNV_OFFSET_BASIS;
+        bool          valid = !resolved.files.empty();
+        for (const auto& key : resolved.files) {
+            auto it = file_hashes.find(key);
+            if (it == file_hashes.end()) {
+                std::optional<std::uint64_t> file_hash;
+                if (auto stream = m_asset_loader.open_shader(key)) {
+                    file_hash = hash_stream(*stream);
+                }
+                it = file_hashes.emplace(key, file_hash).first;
+            }
+            if (!it->second) {
+                valid = false;
+                break;
+            }
+            hash = hash_resolved(hash, key, *it->second);
+        }
+        if (valid && hash == resolved.hash) {
+            unchanged.emplace(name, std::move(resolved));
+        }
+    }
+
+    LOG.info("Loaded {} shaders from \"{}\", {} unchanged", manifest.size(), path.string(),
+             unchanged.size());
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_unchanged = std::move(unchanged);
+}
+
+void ShaderSourceCache::save_manifest(const fs::path& path) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Unchanged shaders that weren't created in this run are still valid
+    auto shaders = m_unchanged;
+    for (const auto& [name, resolved] : m_resolved) {
+        shaders[name] = resolved;
+    }
+
+    std::ofstream file(path, std::ios::trunc);
+    for (const auto& [name, resolved] : shaders) {
+        file << std::hex << std::setw(16) << std::setfill('0') << resolved.hash << ' ' << name
+             << '\n';
+        for (const auto& key : resolved.files) {
+            file << '\t' << key << '\n';
+        }
+    }
+    if (!file) {
+        throw khepri::io::Error("unable to write shader manifest \"" + path.string() + "\"");
+    }
+}
+
+} // namespace openglyph
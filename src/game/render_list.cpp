@@ -0,0 +1,682 @@
+#include <openglyph/game/behaviors/render_behavior.hpp>
+#include <openglyph/game/render_list.hpp>
+#include <openglyph/utility/matrix_batch.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+namespace openglyph {
+namespace {
+
+// Replaces streamed textures in the parameters with their best resident version
+void resolve(std::vector<RenderList::Param>&  params,
+             const renderer::TextureStreamer* texture_streamer)
+{
+    if (texture_streamer != nullptr) {
+        for (auto& param : params) {
+            if (auto* texture = std::get_if<khepri::renderer::Texture*>(&param.value)) {
+                *texture = texture_streamer->resolve(*texture);
+            }
+        }
+    }
+}
+
+// (Re-)builds a mesh's parameter overlay from the model's parameters and the object's overrides.
+// If the result has the same number of parameters as before, the overlay keeps its storage.
+template <typename Overlay>
+void merge(Overlay& overlay, const renderer::RenderModel& model, const RenderBehavior& render,
+           const renderer::TextureStreamer* texture_streamer)
+{
+    const auto& mesh = model.meshes()[overlay.mesh_index];
+    overlay.params.assign(mesh.material_params.begin(), mesh.material_params.end());
+    overlay.slots.assign(mesh.param_slots.begin(), mesh.param_slots.end());
+
+    for (const auto& param_override : render.param_overrides()) {
+        if (param_override.mesh_index != overlay.mesh_index) {
+            continue;
+        }
+
+        if (mesh.material_info == nullptr) {
+            // Unknown material: match parameters by name
+            const auto it = std::find_if(
+                overlay.params.begin(), overlay.params.end(),
+                [&](const auto& param) { return param.name == param_override.param.name; });
+            if (it != overlay.params.end()) {
+                it->value = param_override.param.value;
+            } else {
+                overlay.params.push_back(param_override.param);
+            }
+            continue;
+        }
+
+        // Known material: match parameters by slot and keep them sorted by slot. Parameters that
+        // the material does not list have no slot; they come last and are matched by name.
+        const auto symbol = Symbol::find(param_override.param.name);
+        const auto slot   = (symbol ? mesh.material_info->slot(*symbol) : std::nullopt)
+                              .value_or(renderer::MaterialInfo::NO_SLOT);
+        auto       it     = std::lower_bound(overlay.slots.begin(), overlay.slots.end(), slot);
+        if (slot == renderer::MaterialInfo::NO_SLOT) {
+            while (it != overlay.slots.end() &&
+                   overlay.params[it - overlay.slots.begin()].name != param_override.param.name) {
+                ++it;
+            }
+        }
+        const auto index = it - overlay.slots.begin();
+        if (it != overlay.slots.end() && *it == slot) {
+            overlay.params[index].value = param_override.param.value;
+        } else {
+            overlay.slots.insert(it, slot);
+            overlay.params.insert(overlay.params.begin() + index, param_override.param);
+        }
+    }
+    resolve(overlay.params, texture_streamer);
+}
+
+// Returns the radius of an object's bounding sphere in world space
+float bounding_radius(const khepri::scene::SceneObject& object, const RenderBehavior& render)
+{
+    const auto& scale = object.scale();
+    return static_cast<float>(render.model().bounding_box().radius() * render.scale() *
+                              std::max({std::abs(scale.x), std::abs(scale.y), std::abs(scale.z)}));
+}
+
+// Returns the size of an object on screen, relative to the screen height
+float screen_size(const khepri::Vector3& position, float radius, const khepri::Vector3& eye,
+                  float projection_scale) noexcept
+{
+    const auto dx = position.x - eye.x;
+    const auto dy = position.y - eye.y;
+    const auto dz = position.z - eye.z;
+    const auto distance =
+        std::max(static_cast<float>(std::sqrt(dx * dx + dy * dy + dz * dz)), radius);
+    return distance > 0 ? radius / distance * projection_scale : 0.0f;
+}
+
+// Finds the parameter overlay of a mesh
+template <typename Overlays>
+auto find_overlay(Overlays& overlays, std::size_t mesh_index)
+{
+    return std::find_if(overlays.begin(), overlays.end(),
+                        [&](const auto& overlay) { return overlay.mesh_index == mesh_index; });
+}
+
+} // namespace
+
+RenderList::RenderList()  = default;
+RenderList::~RenderList() = default;
+
+void RenderList::add(khepri::scene::SceneObject& object)
+{
+    auto* render = object.behavior<RenderBehavior>();
+    if (render == nullptr || find(object) != NOT_FOUND) {
+        return;
+    }
+
+    const auto index = m_components.size();
+    auto       slot  = static_cast<std::uint32_t>(m_slots.size());
+    if (m_free_slots.empty()) {
+        m_slots.push_back({static_cast<std::uint32_t>(index), 0});
+    } else {
+        slot = m_free_slots.back();
+        m_free_slots.pop_back();
+        m_slots[slot].component = static_cast<std::uint32_t>(index);
+    }
+    render->render_handle({slot, m_slots[slot].generation});
+    m_object_slots.emplace(&object, slot);
+
+    auto& c = m_components;
+    c.objects.push_back(&object);
+    c.models.push_back(&render->model());
+    c.positions.push_back(object.position());
+    c.scales.push_back(render->scale());
+    c.local_transforms.push_back(khepri::Matrixf::create_scaling(render->scale()));
+    c.world_transforms.emplace_back();
+    c.flags.push_back(render->visible() ? VISIBLE : 0);
+    c.source_transforms.push_back(object.transform());
+    c.radii.push_back(bounding_radius(object, *render));
+    c.lod_reductions.push_back(0);
+    c.overlays.push_back(NO_OVERLAYS);
+    c.param_versions.push_back(0);
+    c.first_instances.push_back(0);
+    c.instance_counts.push_back(0);
+    c.slots.push_back(slot);
+    m_mesh_count += render->model().meshes().size();
+    acquire_shared_params(render->model());
+    update_overlays(index, *render);
+
+    if (!m_rebuild) {
+        // New objects can simply be appended to the instance list
+        append_instances(index);
+    }
+    mark_dirty(index);
+}
+
+void RenderList::remove(const khepri::scene::SceneObject& object)
+{
+    const auto index = find(object);
+    if (index != NOT_FOUND) {
+        remove_at(index);
+    }
+}
+
+void RenderList::remove_at(std::size_t index)
+{
+    // Pending transform updates refer to objects by index, so apply them before moving objects
+    update_transforms();
+
+    // Release the object's handle and parameter overlays
+    auto& c    = m_components;
+    auto& slot = m_slots[c.slots[index]];
+    m_mesh_count -= c.models[index]->meshes().size();
+    release_shared_params(*c.models[index]);
+    ++slot.generation;
+    m_free_slots.push_back(c.slots[index]);
+    m_object_slots.erase(c.objects[index]);
+    if (c.overlays[index] != NO_OVERLAYS) {
+        m_overlays[c.overlays[index]].clear();
+        m_free_overlays.push_back(c.overlays[index]);
+    }
+
+    // Move the last object's components into place; this leaves a hole in the instance list
+    const auto last = c.size() - 1;
+    if (index != last) {
+        c.for_each_array([&](auto& array) { array[index] = std::move(array[last]); });
+        m_slots[c.slots[index]].component = static_cast<std::uint32_t>(index);
+    }
+    c.for_each_array([](auto& array) { array.pop_back(); });
+    m_rebuild = true;
+
+    // The visible objects may refer to the moved object
+    m_culled = false;
+}
+
+void RenderList::update(khepri::scene::SceneObject& object)
+{
+    const auto index = find(object);
+    if (index == NOT_FOUND) {
+        add(object);
+        return;
+    }
+
+    const auto* render = object.behavior<RenderBehavior>();
+    if (render == nullptr) {
+        remove_at(index);
+        return;
+    }
+    update_at(index, *render);
+}
+
+gsl::span<const khepri::scene::SceneObject* const> RenderList::detect_changes()
+{
+    m_changed.clear();
+
+    // Backwards, since removing an object moves the last object into its place
+    const auto& c = m_components;
+    for (auto index = c.size(); index-- > 0;) {
+        const auto* object = c.objects[index];
+        const auto* render = object->behavior<RenderBehavior>();
+        if (render == nullptr) {
+            m_changed.push_back(object);
+            remove_at(index);
+        } else if (changed(index, *render)) {
+            m_changed.push_back(object);
+            update_at(index, *render);
+        }
+    }
+    return m_changed;
+}
+
+#ifndef NDEBUG
+void RenderList::verify_unchanged() const
+{
+    const auto& c = m_components;
+    for (std::size_t index = 0; index < c.size(); ++index) {
+        const auto* render = c.objects[index]->behavior<RenderBehavior>();
+        assert(render != nullptr && !changed(index, *render) &&
+               "object changed without RenderList::update() (Scene::update_object())");
+    }
+}
+#endif
+
+void RenderList::update_at(std::size_t index, const RenderBehavior& render)
+{
+    auto&       c      = m_components;
+    const auto& object = *c.objects[index];
+
+    c.positions[index]        = object.position();
+    c.scales[index]           = render.scale();
+    c.local_transforms[index] = khepri::Matrixf::create_scaling(render.scale());
+    c.radii[index]            = bounding_radius(object, render);
+    mark_dirty(index);
+    if (((c.flags[index] & VISIBLE) != 0) != render.visible()) {
+        c.flags[index] = static_cast<std::uint8_t>(c.flags[index] ^ VISIBLE);
+        m_rebuild      = true;
+    }
+    if (c.param_versions[index] != render.param_version()) {
+        update_overlays(index, render);
+        m_rebuild = true;
+    }
+}
+
+bool RenderList::changed(std::size_t index, const RenderBehavior& render) const noexcept
+{
+    // Transforms are compared bitwise: an object that is set to the same transform again is
+    // unchanged, and any actual change is found
+    const auto& c = m_components;
+    return std::memcmp(&c.objects[index]->transform(), &c.source_transforms[index],
+                       sizeof(khepri::Matrixf)) != 0 ||
+           render.scale() != c.scales[index] ||
+           ((c.flags[index] & VISIBLE) != 0) != render.visible() ||
+           render.param_version() != c.param_versions[index];
+}
+
+void RenderList::resolve_textures(const renderer::TextureStreamer& texture_streamer)
+{
+    if (m_texture_streamer == &texture_streamer &&
+        m_texture_generation == texture_streamer.generation()) {
+        return;
+    }
+
+    if (m_texture_streamer != &texture_streamer) {
+        // The instances reference the previous shared parameters; start over
+        for (auto& [model, shared] : m_resolved_params) {
+            m_retired_params.push_back(std::move(shared.blocks));
+            shared.blocks.clear();
+        }
+        m_rebuild = true;
+    }
+    m_texture_streamer   = &texture_streamer;
+    m_texture_generation = texture_streamer.generation();
+
+    // Re-resolve all parameter blocks in place, so the instances' spans into them stay valid
+    for (auto& [model, shared] : m_resolved_params) {
+        auto& blocks = shared.blocks;
+        for (std::size_t i = 0; i < blocks.size(); ++i) {
+            const auto& model_params = model->meshes()[i].material_params;
+            blocks[i].assign(model_params.begin(), model_params.end());
+            resolve(blocks[i], m_texture_streamer);
+        }
+    }
+    const auto& c = m_components;
+    for (std::size_t i = 0; i < c.size(); ++i) {
+        if (c.overlays[i] == NO_OVERLAYS) {
+            continue;
+        }
+        const auto* render = c.objects[i]->behavior<RenderBehavior>();
+        for (auto& overlay : m_overlays[c.overlays[i]]) {
+            const auto* params = overlay.params.data();
+            const auto* slots  = overlay.slots.data();
+            merge(overlay, *c.models[i], *render, m_texture_streamer);
+            if (overlay.params.data() != params || overlay.slots.data() != slots) {
+                m_rebuild = true;
+            }
+        }
+    }
+}
+
+void RenderList::resolve_meshes(const renderer::ModelStreamer& model_streamer)
+{
+    // Rebuilding rewrites the instances of all objects with their newly selected variants
+    if (m_mesh_generation != model_streamer.generation()) {
+        m_mesh_generation = model_streamer.generation();
+        m_rebuild         = true;
+    }
+}
+
+void RenderList::request_textures(renderer::TextureStreamer& texture_streamer,
+                                  const khepri::Vector3& eye, float projection_scale) const
+{
+    const auto& c = m_components;
+    for (std::size_t n = 0; n < active_count(); ++n) {
+        const auto i = active(n);
+        if ((c.flags[i] & VISIBLE) == 0) {
+            continue;
+        }
+        const auto  size   = screen_size(c.positions[i], c.radii[i], eye, projection_scale);
+        const auto& meshes = c.models[i]->meshes();
+        for (const auto& group : c.models[i]->lod_groups()) {
+            const auto& mesh = meshes[group.select(c.lod_reductions[i])];
+            if (!mesh.visible) {
+                continue;
+            }
+            for (const auto& param : mesh.material_params) {
+                if (auto* texture = std::get_if<khepri::renderer::Texture*>(&param.value)) {
+                    texture_streamer.request(*texture, size);
+                }
+            }
+        }
+    }
+}
+
+void RenderList::cull(gsl::span<const khepri::scene::SceneObject* const> visible_objects)
+{
+    m_visible.clear();
+    for (const auto* object : visible_objects) {
+        if (object->behavior<RenderBehavior>() == nullptr) {
+            continue;
+        }
+        if (const auto index = find(*object); index != NOT_FOUND) {
+            m_visible.push_back(index);
+        }
+    }
+    m_culled = true;
+}
+
+gsl::span<const khepri::renderer::MeshInstance> RenderList::instances(ThreadPool* thread_pool)
+{
+    update_transforms();
+    if (m_rebuild) {
+        rebuild(thread_pool);
+    }
+    return m_instances;
+}
+
+void RenderList::extract(RenderSnapshot& snapshot, ThreadPool* thread_pool)
+{
+    update_transforms();
+    if (m_rebuild) {
+        rebuild(thread_pool);
+    }
+
+    // Parameter overlays change along with their objects, so they are copied into the snapshot
+    snapshot.clear();
+    const auto& c = m_components;
+    for (std::size_t n = 0; n < active_count(); ++n) {
+        const auto index = active(n);
+        const auto first = c.first_instances[index];
+        const auto last  = first + c.instance_counts[index];
+        for (auto i = first; i < last; ++i) {
+            if (c.overlays[index] != NO_OVERLAYS) {
+                snapshot.add_copy(m_instances[i], m_param_slots[i], m_sort_keys[i], m_positions[i]);
+            } else {
+                snapshot.add(m_instances[i], m_param_slots[i], m_sort_keys[i], m_positions[i]);
+            }
+        }
+    }
+}
+
+gsl::span<const khepri::renderer::MeshInstance>
+RenderList::sorted_instances(const khepri::Vector3& eye, ThreadPool* thread_pool)
+{
+    extract(m_snapshot, thread_pool);
+    return m_snapshot.sorted_instances(eye, thread_pool);
+}
+
+std::size_t RenderList::find(const khepri::scene::SceneObject& object) const noexcept
+{
+    const auto& objects = m_components.objects;
+    if (const auto* render = object.behavior<RenderBehavior>()) {
+        const auto handle = render->render_handle();
+        if (handle.valid() && handle.index < m_slots.size()) {
+            const auto& slot = m_slots[handle.index];
+            if (slot.generation == handle.generation && slot.component < objects.size() &&
+                objects[slot.component] == &object) {
+                return slot.component;
+            }
+        }
+    }
+
+    // The object's handle was lost with its RenderBehavior, or refers to another list
+    const auto it = m_object_slots.find(&object);
+    return it != m_object_slots.end() ? m_slots[it->second].component : NOT_FOUND;
+}
+
+void RenderList::acquire_shared_params(const renderer::RenderModel& model)
+{
+    ++m_resolved_params[&model].users;
+}
+
+void RenderList::release_shared_params(const renderer::RenderModel& model)
+{
+    const auto it = m_resolved_params.find(&model);
+    assert(it != m_resolved_params.end() && it->second.users > 0);
+    if (--it->second.users == 0) {
+        // The model may be destroyed after this, and another model may be created at its address
+        m_retired_params.push_back(std::move(it->second.blocks));
+        m_resolved_params.erase(it);
+    }
+}
+
+void RenderList::create_shared_params(const renderer::RenderModel& model)
+{
+    if (m_texture_streamer == nullptr) {
+        return;
+    }
+
+    auto& blocks = m_resolved_params.at(&model).blocks;
+    if (blocks.empty()) {
+        for (const auto& model_mesh : model.meshes()) {
+            auto& params = blocks.emplace_back(model_mesh.material_params.begin(),
+                                               model_mesh.material_params.end());
+            resolve(params, m_texture_streamer);
+        }
+    }
+}
+
+gsl::span<const RenderList::Param>
+RenderList::shared_params(const renderer::RenderModel& model, std::size_t mesh) const
+{
+    if (m_texture_streamer == nullptr) {
+        return model.meshes()[mesh].material_params;
+    }
+    const auto it = m_resolved_params.find(&model);
+    assert(it != m_resolved_params.end());
+    return it->second.blocks[mesh];
+}
+
+void RenderList::select_lods(const khepri::Vector3& eye, float projection_scale,
+                             const renderer::LodSettings& settings, ThreadPool* thread_pool)
+{
+    // Objects outside the view keep their LoD until they are visible again
+    auto&             c = m_components;
+    std::atomic<bool> counts_changed{false};
+    for_each_range(thread_pool, active_count(), [&](std::size_t begin, std::size_t end) {
+        for (std::size_t n = begin; n < end; ++n) {
+            const auto i = active(n);
+            if ((c.flags[i] & VISIBLE) == 0 || !c.models[i]->has_lods()) {
+                continue;
+            }
+
+            const auto size = screen_size(c.positions[i], c.radii[i], eye, projection_scale);
+            const auto reduction =
+                renderer::select_lod_reduction(size, c.lod_reductions[i], settings);
+            if (reduction == c.lod_reductions[i]) {
+                continue;
+            }
+            c.lod_reductions[i] = reduction;
+
+            // Swap the meshes in place, unless the number of visible meshes changes
+            if (!m_rebuild) {
+                if (count_instances(i) == c.instance_counts[i]) {
+                    write_instances(i);
+                } else {
+                    counts_changed = true;
+                }
+            }
+        }
+    });
+    if (counts_changed) {
+        m_rebuild = true;
+    }
+}
+
+void RenderList::mark_dirty(std::size_t index)
+{
+    auto& flags = m_components.flags[index];
+    if ((flags & DIRTY) == 0) {
+        flags = static_cast<std::uint8_t>(flags | DIRTY);
+        m_dirty.push_back(index);
+    }
+}
+
+void RenderList::update_transforms()
+{
+    if (m_dirty.empty()) {
+        return;
+    }
+
+    // Gather the matrices of all changed objects, multiply them in one batch and scatter them
+    auto& c = m_components;
+    m_dirty_transforms.clear();
+    m_dirty_local_transforms.clear();
+    for (const auto index : m_dirty) {
+        c.source_transforms[index] = c.objects[index]->transform();
+        m_dirty_transforms.push_back(c.source_transforms[index]);
+        m_dirty_local_transforms.push_back(c.local_transforms[index]);
+    }
+    m_dirty_world_transforms.resize(m_dirty.size());
+    multiply_batch(m_dirty_transforms, m_dirty_local_transforms, m_dirty_world_transforms);
+
+    for (std::size_t i = 0; i < m_dirty.size(); ++i) {
+        const auto index          = m_dirty[i];
+        c.world_transforms[index] = m_dirty_world_transforms[i];
+        c.flags[index]            = static_cast<std::uint8_t>(c.flags[index] & ~DIRTY);
+        if (!m_rebuild) {
+            const auto first = c.first_instances[index];
+            for (std::size_t j = 0; j < c.instance_counts[index]; ++j) {
+                m_instances[first + j].transform = c.world_transforms[index];
+                m_positions[first + j]           = c.positions[index];
+            }
+        }
+    }
+    m_dirty.clear();
+}
+
+void RenderList::update_overlays(std::size_t index, const RenderBehavior& render)
+{
+    auto& c = m_components;
+    if (c.overlays[index] == NO_OVERLAYS && !render.param_overrides().empty()) {
+        if (m_free_overlays.empty()) {
+            c.overlays[index] = static_cast<std::uint32_t>(m_overlays.size());
+            m_overlays.emplace_back();
+        } else {
+            c.overlays[index] = m_free_overlays.back();
+            m_free_overlays.pop_back();
+        }
+    }
+
+    if (c.overlays[index] != NO_OVERLAYS) {
+        auto& overlays = m_overlays[c.overlays[index]];
+        overlays.clear();
+        for (const auto& param_override : render.param_overrides()) {
+            const auto mesh_index = param_override.mesh_index;
+            if (mesh_index < c.models[index]->meshes().size() &&
+                find_overlay(overlays, mesh_index) == overlays.end()) {
+                auto& overlay = overlays.emplace_back(ParamOverlay{mesh_index, {}, {}});
+                merge(overlay, *c.models[index], render, m_texture_streamer);
+            }
+        }
+        if (overlays.empty()) {
+            m_free_overlays.push_back(c.overlays[index]);
+            c.overlays[index] = NO_OVERLAYS;
+        }
+    }
+    c.param_versions[index] = render.param_version();
+}
+
+std::size_t RenderList::count_instances(std::size_t index) const noexcept
+{
+    const auto& c = m_components;
+    if ((c.flags[index] & VISIBLE) == 0) {
+        return 0;
+    }
+    const auto& model_meshes = c.models[index]->meshes();
+    const auto& lod_groups   = c.models[index]->lod_groups();
+    return std::count_if(lod_groups.begin(), lod_groups.end(), [&](const auto& group) {
+        return model_meshes[group.select(c.lod_reductions[index])].visible;
+    });
+}
+
+void RenderList::write_instances(std::size_t index)
+{
+    const auto& c = m_components;
+    if (c.instance_counts[index] == 0) {
+        return;
+    }
+
+    const auto* overlays =
+        c.overlays[index] != NO_OVERLAYS ? &m_overlays[c.overlays[index]] : nullptr;
+    const auto& model        = *c.models[index];
+    const auto& model_meshes = model.meshes();
+    auto        instance     = c.first_instances[index];
+    for (const auto& group : model.lod_groups()) {
+        const auto i = group.select(c.lod_reductions[index]);
+        if (!model_meshes[i].visible) {
+            continue;
+        }
+
+        gsl::span<const Param>         params = shared_params(model, i);
+        gsl::span<const std::uint32_t> slots  = model_meshes[i].param_slots;
+        if (overlays != nullptr) {
+            if (const auto it = find_overlay(*overlays, i); it != overlays->end()) {
+                params = it->params;
+                slots  = it->slots;
+            }
+        }
+
+        m_instances[instance]   = {model_meshes[i].render_mesh.get(), c.world_transforms[index],
+                                   model_meshes[i].material, params};
+        m_param_slots[instance] = slots;
+        m_sort_keys[instance]   = model_meshes[i].sort_key;
+        m_positions[instance]   = c.positions[index];
+        ++instance;
+    }
+}
+
+void RenderList::resize_instances(std::size_t size)
+{
+    m_instances.resize(size);
+    m_param_slots.resize(size);
+    m_sort_keys.resize(size);
+    m_positions.resize(size);
+}
+
+void RenderList::append_instances(std::size_t index)
+{
+    auto& c = m_components;
+    create_shared_params(*c.models[index]);
+    c.first_instances[index] = m_instances.size();
+    c.instance_counts[index] = count_instances(index);
+    resize_instances(c.first_instances[index] + c.instance_counts[index]);
+    write_instances(index);
+}
+
+void RenderList::rebuild(ThreadPool* thread_pool)
+{
+    auto& c = m_components;
+
+    // All instances are rewritten, so nothing refers to the retired parameters after this
+    m_retired_params.clear();
+
+    // Creating shared parameters modifies the list, so that can't happen in parallel
+    for (const auto* model : c.models) {
+        create_shared_params(*model);
+    }
+
+    // Count every object's instances, then lay out the instances in the order of the objects.
+    // Each object writes its own range, so the result does not depend on the number of threads.
+    for_each_range(thread_pool, c.size(), [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            c.instance_counts[i] = count_instances(i);
+        }
+    });
+    std::size_t num_instances = 0;
+    for (std::size_t i = 0; i < c.size(); ++i) {
+        c.first_instances[i] = num_instances;
+        num_instances += c.instance_counts[i];
+    }
+
+    // Resizing keeps the capacity, so compaction does not reallocate in steady state
+    resize_instances(num_instances);
+    for_each_range(thread_pool, c.size(), [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            write_instances(i);
+        }
+    });
+    m_rebuild = false;
+}
+
+} // namespace openglyph
@@ -0,0 +1,74 @@
+#include <openglyph/game/render_snapshot.hpp>
+#include <openglyph/renderer/sort_key.hpp>
+#include <openglyph/utility/radix_sort.hpp>
+
+namespace openglyph {
+
+RenderSnapshot::RenderSnapshot()  = default;
+RenderSnapshot::~RenderSnapshot() = default;
+
+gsl::span<const khepri::renderer::MeshInstance>
+RenderSnapshot::sorted_instances(const khepri::Vector3& eye, ThreadPool* thread_pool)
+{
+    m_sort_items.resize(m_instances.size());
+    for_each_range(thread_pool, m_instances.size(), [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            const auto& position    = m_positions[i];
+            const auto  dx          = position.x - eye.x;
+            const auto  dy          = position.y - eye.y;
+            const auto  dz          = position.z - eye.z;
+            const auto  distance_sq = static_cast<float>(dx * dx + dy * dy + dz * dz);
+            m_sort_items[i] = {renderer::SortKey::with_depth(m_sort_keys[i], distance_sq),
+                               static_cast<std::uint32_t>(i)};
+        }
+    });
+    radix_sort(m_sort_items, m_sort_scratch);
+
+    m_sorted_instances.resize(m_sort_items.size());
+    m_sorted_param_slots.resize(m_sort_items.size());
+    for_each_range(thread_pool, m_sort_items.size(), [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            m_sorted_instances[i]   = m_instances[m_sort_items[i].second];
+            m_sorted_param_slots[i] = m_param_slots[m_sort_items[i].second];
+        }
+    });
+    return m_sorted_instances;
+}
+
+void RenderSnapshot::clear() noexcept
+{
+    m_instances.clear();
+    m_sort_keys.clear();
+    m_positions.clear();
+    m_param_slots.clear();
+    m_num_copies = 0;
+}
+
+void RenderSnapshot::add(const khepri::renderer::MeshInstance& instance,
+                         gsl::span<const std::uint32_t> slots, std::uint64_t sort_key,
+                         const khepri::Vector3& position)
+{
+    m_instances.push_back(instance);
+    m_param_slots.push_back(slots);
+    m_sort_keys.push_back(sort_key);
+    m_positions.push_back(position);
+}
+
+void RenderSnapshot::add_copy(const khepri::renderer::MeshInstance& instance,
+                              gsl::span<const std::uint32_t> slots, std::uint64_t sort_key,
+                              const khepri::Vector3& position)
+{
+    if (m_num_copies == m_copies.size()) {
+        m_copies.emplace_back();
+    }
+    // Moving the blocks when m_copies grows keeps their storage, so earlier spans stay valid
+    auto& [params, param_slots] = m_copies[m_num_copies++];
+    params.assign(instance.material_params.begin(), instance.material_params.end());
+    param_slots.assign(slots.begin(), slots.end());
+
+    auto copy            = instance;
+    copy.material_params = params;
+    add(copy, param_slots, sort_key, position);
+}
+
+} // namespace openglyph
@@ -2,7 +2,36 @@
 #include <openglyph/game/scene.hpp>
 #include <openglyph/renderer/io/model.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <utility>
+
 namespace openglyph {
+namespace {
+
+// Returns a box that encloses an object's render model in any orientation of the object
+renderer::BoundingBox world_bounds(const khepri::scene::SceneObject& object)
+{
+    float radius = 0;
+    if (const auto* render = object.behavior<RenderBehavior>()) {
+        const auto& box    = render->model().bounding_box();
+        const auto  center = box.center();
+        const auto& scale  = object.scale();
+        radius             = static_cast<float>(
+            (std::sqrt(center.x * center.x + center.y * center.y + center.z * center.z) +
+             box.radius()) *
+            render->scale() * std::max({std::abs(scale.x), std::abs(scale.y), std::abs(scale.z)}));
+    }
+
+    const auto& position = object.position();
+    const auto  x        = static_cast<float>(position.x);
+    const auto  y        = static_cast<float>(position.y);
+    const auto  z        = static_cast<float>(position.z);
+    return {{x - radius, y - radius, z - radius}, {x + radius, y + radius, z + radius}};
+}
+
+} // namespace
 
 Scene::Scene(AssetCache& asset_cache, const GameObjectTypeStore& game_object_types,
              Environment environment)
@@ -24,4 +53,74 @@ Scene::Scene(AssetCache& asset_cache, const GameObjectTypeStore& game_object_typ
 
 Scene::~Scene() = default;
 
+void Scene::add_object(const std::shared_ptr<khepri::scene::SceneObject>& object)
+{
+    if (find(*object) != SpatialIndex::INVALID_ID) {
+        return;
+    }
+    const auto id = m_spatial_index.insert(world_bounds(*object), *object);
+    if (auto* render = object->behavior<RenderBehavior>()) {
+        render->spatial_id(id);
+    }
+    m_spatial_ids.emplace(object.get(), id);
+    m_scene.add_object(object);
+    m_render_list.add(*object);
+}
+
+void Scene::remove_object(const std::shared_ptr<khepri::scene::SceneObject>& object)
+{
+    const auto id = find(*object);
+    if (id == SpatialIndex::INVALID_ID) {
+        return;
+    }
+    m_spatial_index.remove(id);
+    if (auto* render = object->behavior<RenderBehavior>()) {
+        render->spatial_id(SpatialIndex::INVALID_ID);
+    }
+    m_spatial_ids.erase(object.get());
+    m_render_list.remove(*object);
+    m_scene.remove_object(object);
+}
+
+void Scene::update_object(const std::shared_ptr<khepri::scene::SceneObject>& object)
+{
+    const auto id = find(*object);
+    if (id == SpatialIndex::INVALID_ID) {
+        return;
+    }
+    m_spatial_index.update(id, world_bounds(*object));
+    m_render_list.update(*object);
+}
+
+RenderList& Scene::update_render_list() const
+{
+    if (m_change_detection) {
+        for (const auto* object : m_render_list.detect_changes()) {
+            const auto id = find(*object);
+            if (id != SpatialIndex::INVALID_ID) {
+                m_spatial_index.update(id, world_bounds(*object));
+            }
+        }
+    } else {
+#ifndef NDEBUG
+        m_render_list.verify_unchanged();
+#endif
+    }
+    return m_render_list;
+}
+
+SpatialIndex::Id Scene::find(const khepri::scene::SceneObject& object) const
+{
+    static_assert(std::is_same_v<decltype(std::declval<RenderBehavior>().spatial_id()),
+                                 SpatialIndex::Id>);
+    if (const auto* render = object.behavior<RenderBehavior>()) {
+        const auto id = render->spatial_id();
+        if (m_spatial_index.contains(id, object)) {
+            return id;
+        }
+    }
+    const auto it = m_spatial_ids.find(&object);
+    return it != m_spatial_ids.end() ? it->second : SpatialIndex::INVALID_ID;
+}
+
 } // namespace openglyph
@@ -1,64 +1,382 @@
 #include <openglyph/game/behaviors/render_behavior.hpp>
 #include <openglyph/game/scene_renderer.hpp>
+#include <openglyph/renderer/frustum.hpp>
+#include <openglyph/utility/matrix_layout.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+#include <variant>
 
 namespace openglyph {
 namespace {
 
-class RenderState
+using Param = khepri::renderer::Material::Param;
+
+// Checks if two parameter blocks hold the same parameters, in the same order. Values are compared
+// bitwise: values that are equal but encoded differently (such as 0 and -0) are considered
+// different, but different values are never considered equal.
+bool same_params(gsl::span<const Param> params1, gsl::span<const Param> params2)
+{
+    if (params1.size() != params2.size()) {
+        return false;
+    }
+    if (params1.data() == params2.data()) {
+        return true;
+    }
+    for (std::size_t i = 0; i < params1.size(); ++i) {
+        const auto& value1 = params1[i].value;
+        const auto& value2 = params2[i].value;
+        if (value1.index() != value2.index() || params1[i].name != params2[i].name) {
+            return false;
+        }
+        const bool equal = std::visit(
+            [&](const auto& v1) {
+                using T = std::decay_t<decltype(v1)>;
+                static_assert(std::is_trivially_copyable_v<T>);
+                return std::memcmp(&v1, &std::get<T>(value2), sizeof(T)) == 0;
+            },
+            value1);
+        if (!equal) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Returns the vertical scale factor of a perspective projection matrix (cot(fov_y / 2))
+float projection_scale(const khepri::Matrixf& projection)
+{
+    return openglyph::matrix_elements(projection)[5];
+}
+
+// Returns the size of an object, relative to the screen height
+float screen_size(const khepri::scene::SceneObject& object, const RenderBehavior& render,
+                  const khepri::renderer::Camera& camera, float projection_scale)
+{
+    const auto& scale  = object.scale();
+    const auto  radius = render.model().bounding_box().radius() * render.scale() *
+                        std::max({std::abs(scale.x), std::abs(scale.y), std::abs(scale.z)});
+
+    const auto& position = object.position();
+    const auto& eye      = camera.position();
+    const auto  dx       = position.x - eye.x;
+    const auto  dy       = position.y - eye.y;
+    const auto  dz       = position.z - eye.z;
+    const auto  distance = std::max(std::sqrt(dx * dx + dy * dy + dz * dz), radius);
+    if (distance <= 0) {
+        return 0;
+    }
+    return static_cast<float>(radius / distance) * projection_scale;
+}
+
+// Returns true if every LoD variant of a model's meshes is resident
+bool fully_resident(const openglyph::renderer::RenderModel& model) noexcept
+{
+    const auto& groups = model.lod_groups();
+    return std::all_of(groups.begin(), groups.end(), [](const auto& group) {
+        return group.resident == group.meshes.size();
+    });
+}
+
+#ifdef OPENGLYPH_RENDER_STATISTICS
+// Adds the time until the end of the scope to a duration
+class ScopedTimer final
 {
 public:
-    struct Mesh
-    {
-        using Param = renderer::RenderModel::Mesh::Param;
+    explicit ScopedTimer(std::chrono::nanoseconds& duration)
+        : m_duration(duration), m_start(std::chrono::steady_clock::now())
+    {}
 
-        std::vector<Param> material_params;
-    };
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
 
-    explicit RenderState(const renderer::RenderModel& model, const khepri::Matrixf& transform)
-        : meshes(model.meshes().size()), transform(transform)
+    ~ScopedTimer()
     {
-        const auto& model_meshes = model.meshes();
-        for (std::size_t i = 0; i < model_meshes.size(); ++i) {
-            meshes[i].material_params.insert(meshes[i].material_params.end(),
-                                             model_meshes[i].material_params.begin(),
-                                             model_meshes[i].material_params.end());
-        }
+        m_duration += std::chrono::steady_clock::now() - m_start;
     }
 
-    std::vector<Mesh> meshes;
-    khepri::Matrixf   transform;
+private:
+    std::chrono::nanoseconds&             m_duration;
+    std::chrono::steady_clock::time_point m_start;
+};
+#else
+// Without statistics, timers do nothing
+class ScopedTimer final
+{
+public:
+    explicit ScopedTimer(std::chrono::nanoseconds& /*duration*/) noexcept {}
 };
+#endif
+
 } // namespace
 
-void SceneRenderer::render_scene(const openglyph::Scene&         scene,
+void SceneRenderer::render_scene(const openglyph::Scene&        scene,
                                  const khepri::renderer::Camera& camera)
 {
-    std::vector<khepri::renderer::MeshInstance> meshes;
-
-    for (const auto& object : scene.objects()) {
-        if (const auto* render = object->behavior<RenderBehavior>()) {
-            auto* state = object->user_data<RenderState>();
-            if (!state) {
-                object->user_data(
-                    RenderState{render->model(), khepri::Matrixf::create_scaling(render->scale())});
-                state = object->user_data<RenderState>();
-            }
+    extract(scene, camera, m_snapshot);
+    render_snapshot(m_snapshot);
+}
 
-            const auto& transform    = object->transform();
-            const auto& model_meshes = render->model().meshes();
+void SceneRenderer::extract(const openglyph::Scene& scene, const khepri::renderer::Camera& camera,
+                            RenderSnapshot& snapshot)
+{
+    m_statistics = {};
+    ScopedTimer total_timer(m_statistics.total_time);
+
+    // Changed objects are updated first, as culling uses their bounds
+    auto&      render_list = scene.update_render_list();
+    const auto proj_scale  = projection_scale(camera.matrices().projection);
 
-            assert(model_meshes.size() == state->meshes.size());
-            for (std::size_t i = 0; i < state->meshes.size(); ++i) {
-                if (model_meshes[i].visible) {
-                    meshes.push_back({model_meshes[i].render_mesh.get(),
-                                      transform * state->transform, model_meshes[i].material,
-                                      state->meshes[i].material_params});
+    // Only objects in the view frustum are processed further. The scene's spatial index finds
+    // them without visiting every object. Of those, objects hidden behind others are removed.
+    // Objects without a RenderBehavior are not drawn, so they are skipped right away.
+    const bool culling = m_frustum_culling || m_occlusion_settings;
+    if (culling) {
+        ScopedTimer timer(m_statistics.culling_time);
+        m_visible_objects.clear();
+        if (m_frustum_culling) {
+            const auto frustum =
+                openglyph::renderer::Frustum::from_matrices(camera.matrices().view_proj);
+            scene.query_frustum(frustum, [&](khepri::scene::SceneObject& object) {
+                if (object.behavior<RenderBehavior>() != nullptr) {
+                    m_visible_objects.push_back(&object);
+                }
+            });
+        } else {
+            for (const auto& object : scene.objects()) {
+                if (object->behavior<RenderBehavior>() != nullptr) {
+                    m_visible_objects.push_back(object.get());
                 }
             }
         }
+        if (m_occlusion_settings) {
+            const auto num_visited = m_visible_objects.size();
+            cull_occluded(camera, proj_scale);
+            if constexpr (RENDER_STATISTICS_ENABLED) {
+                m_statistics.objects_occluded = num_visited - m_visible_objects.size();
+            }
+        }
+        render_list.cull(m_visible_objects);
+    } else {
+        render_list.reset_culling();
+    }
+
+    if (m_model_streamer != nullptr) {
+        // Like textures, meshes become resident here so that they are not created while a
+        // snapshot is rendered
+        ScopedTimer timer(m_statistics.lod_time);
+        m_model_streamer->update();
+        render_list.resolve_meshes(*m_model_streamer);
+    }
+
+    {
+        // Without LoD settings, select_lods() still restores objects that were reduced before
+        ScopedTimer timer(m_statistics.lod_time);
+        static const openglyph::renderer::LodSettings full_detail{{}, 0};
+        render_list.select_lods(camera.position(), proj_scale,
+                                m_lod_settings ? *m_lod_settings : full_detail, m_thread_pool);
+    }
+
+    if (m_texture_streamer != nullptr) {
+        // The snapshot refers to resolved textures, so the streamer is updated here rather than
+        // while the snapshot is rendered. Updates take effect in the next snapshot.
+        ScopedTimer timer(m_statistics.texture_time);
+        render_list.resolve_textures(*m_texture_streamer);
+        render_list.request_textures(*m_texture_streamer, camera.position(), proj_scale);
+        m_texture_streamer->update();
+    }
+
+    {
+        ScopedTimer timer(m_statistics.extract_time);
+        render_list.extract(snapshot, m_thread_pool);
+        snapshot.camera(camera);
+    }
+
+    if constexpr (RENDER_STATISTICS_ENABLED) {
+        count_meshes(render_list, culling, snapshot.instances().size());
+    }
+}
+
+void SceneRenderer::render_snapshot(RenderSnapshot& snapshot)
+{
+    if (!snapshot.camera()) {
+        return;
+    }
+
+    {
+        ScopedTimer total_timer(m_statistics.total_time);
+        const auto& camera = *snapshot.camera();
+
+        gsl::span<const khepri::renderer::MeshInstance> instances;
+        {
+            ScopedTimer timer(m_statistics.sort_time);
+            instances = snapshot.sorted_instances(camera.position(), m_thread_pool);
+        }
+        {
+            ScopedTimer timer(m_statistics.submit_time);
+            if (m_instanced_renderer) {
+                render_batched(instances, snapshot.sorted_param_slots(), camera);
+            } else {
+                m_renderer.render_meshes(instances, camera);
+            }
+        }
+
+        if constexpr (RENDER_STATISTICS_ENABLED) {
+            count_submitted(instances);
+        }
+    }
+
+    if constexpr (RENDER_STATISTICS_ENABLED) {
+        if (m_statistics_callback) {
+            m_statistics_callback(m_statistics);
+        }
+    }
+}
+
+void SceneRenderer::count_meshes(const RenderList& render_list, bool culled,
+                                 std::size_t num_instances)
+{
+    auto& stats = m_statistics;
+    if (culled) {
+        // The visible objects all have a RenderBehavior
+        stats.objects_visited = m_visible_objects.size() + stats.objects_occluded;
+        for (const auto* object : m_visible_objects) {
+            stats.meshes_considered += object->behavior<RenderBehavior>()->model().meshes().size();
+        }
+    } else {
+        stats.objects_visited   = render_list.size();
+        stats.meshes_considered = render_list.mesh_count();
+    }
+    stats.meshes_culled   = render_list.mesh_count() - stats.meshes_considered;
+    stats.meshes_rejected = stats.meshes_considered - num_instances;
+}
+
+void SceneRenderer::count_submitted(gsl::span<const khepri::renderer::MeshInstance> instances)
+{
+    auto& stats               = m_statistics;
+    stats.instances_submitted = instances.size();
+    stats.draw_calls          = m_instanced_renderer ? m_batches.size() : instances.size();
+
+    const auto count_unique = [&](auto&& get) {
+        m_unique_buffer.clear();
+        for (const auto& instance : instances) {
+            m_unique_buffer.push_back(get(instance));
+        }
+        std::sort(m_unique_buffer.begin(), m_unique_buffer.end());
+        return static_cast<std::size_t>(
+            std::unique(m_unique_buffer.begin(), m_unique_buffer.end()) - m_unique_buffer.begin());
+    };
+    stats.unique_meshes =
+        count_unique([](const auto& instance) -> const void* { return instance.mesh; });
+    stats.unique_materials =
+        count_unique([](const auto& instance) -> const void* { return instance.material; });
+}
+
+void SceneRenderer::occlusion_culling(
+    std::optional<openglyph::renderer::OcclusionSettings> settings)
+{
+    m_occlusion_settings = std::move(settings);
+    m_occlusion_buffer.reset();
+    if (m_occlusion_settings) {
+        m_occlusion_buffer.emplace(m_occlusion_settings->width, m_occlusion_settings->height);
+    }
+}
+
+void SceneRenderer::cull_occluded(const khepri::renderer::Camera& camera, float projection_scale)
+{
+    const auto& settings = *m_occlusion_settings;
+    auto&       buffer   = *m_occlusion_buffer;
+    buffer.clear(camera.matrices().view_proj);
+
+    const auto world_transform = [](const khepri::scene::SceneObject& object,
+                                    const RenderBehavior&             render) {
+        return object.transform() * khepri::Matrixf::create_scaling(render.scale());
+    };
+
+    // Occluders are built from the most detailed meshes, so only objects that are large enough
+    // on screen to draw those can occlude
+    auto min_size = settings.min_occluder_size;
+    if (m_lod_settings && !m_lod_settings->thresholds.empty()) {
+        min_size = std::max(min_size, m_lod_settings->thresholds.front() *
+                                          (1 + m_lod_settings->hysteresis));
+    }
+
+    // Use the objects that are largest on screen as occluders
+    m_occluders.clear();
+    for (const auto* object : m_visible_objects) {
+        const auto* render = object->behavior<RenderBehavior>();
+        if (render == nullptr || !render->visible() ||
+            render->model().occluder().indices.empty() || !fully_resident(render->model())) {
+            continue;
+        }
+        const auto size = screen_size(*object, *render, camera, projection_scale);
+        if (size >= min_size) {
+            m_occluders.emplace_back(size, object);
+        }
+    }
+    const auto num_occluders = std::min(m_occluders.size(), settings.max_occluders);
+    if (num_occluders == 0) {
+        return;
+    }
+    std::partial_sort(m_occluders.begin(), m_occluders.begin() + num_occluders, m_occluders.end(),
+                      [](const auto& o1, const auto& o2) { return o1.first > o2.first; });
+
+    for (std::size_t i = 0; i < num_occluders; ++i) {
+        const auto& object   = *m_occluders[i].second;
+        const auto& render   = *object.behavior<RenderBehavior>();
+        const auto& occluder = render.model().occluder();
+        buffer.add_occluder(occluder.vertices, occluder.indices, world_transform(object, render));
+    }
+
+    // Occluders pass this test themselves, as their geometry lies within their bounds
+    const auto hidden = [&](const khepri::scene::SceneObject* object) {
+        const auto* render = object->behavior<RenderBehavior>();
+        if (render == nullptr) {
+            return false;
+        }
+        const auto& bounds = render->model().bounding_box();
+        return !buffer.is_visible(bounds, world_transform(*object, *render));
+    };
+    m_visible_objects.erase(
+        std::remove_if(m_visible_objects.begin(), m_visible_objects.end(), hidden),
+        m_visible_objects.end());
+}
+
+void SceneRenderer::render_batched(gsl::span<const khepri::renderer::MeshInstance>   instances,
+                                   gsl::span<const gsl::span<const std::uint32_t>> param_slots,
+                                   const khepri::renderer::Camera&                   camera)
+{
+    m_batches.clear();
+    m_batch_transforms.clear();
+
+    // Reserving up front ensures the batches' transform spans stay valid while filling them
+    m_batch_transforms.reserve(instances.size());
+
+    // Instances are grouped only when they are adjacent, so the draw order (and thus back-to-front
+    // order of translucent instances) is preserved. Objects that share a parameter block are
+    // matched by identity; other parameters are compared by value, so instances with identical
+    // but separately stored parameters are batched as well.
+    for (std::size_t i = 0; i < instances.size(); ++i) {
+        const auto& instance = instances[i];
+        m_batch_transforms.push_back(instance.transform);
+        if (!m_batches.empty()) {
+            auto& batch = m_batches.back();
+            if (batch.mesh == instance.mesh && batch.material == instance.material &&
+                same_params(batch.material_params, instance.material_params) &&
+                std::equal(batch.param_slots.begin(), batch.param_slots.end(),
+                           param_slots[i].begin(), param_slots[i].end())) {
+                batch.transforms = {batch.transforms.data(), batch.transforms.size() + 1};
+                continue;
+            }
+        }
+        m_batches.push_back({instance.mesh, instance.material, instance.material_params,
+                             param_slots[i], {&m_batch_transforms.back(), 1}});
     }
 
-    m_renderer.render_meshes(meshes, camera);
+    m_instanced_renderer(m_batches, camera);
 }
 
 } // namespace openglyph
@@ -0,0 +1,251 @@
+#include <openglyph/game/spatial_index.hpp>
+
+#include <cassert>
+
+namespace openglyph {
+namespace {
+
+// Returns the box that encloses both boxes
+SpatialIndex::BoundingBox combine(const SpatialIndex::BoundingBox& a,
+                                  const SpatialIndex::BoundingBox& b) noexcept
+{
+    auto result = a;
+    result.merge(b);
+    return result;
+}
+
+} // namespace
+
+SpatialIndex::Id SpatialIndex::insert(const BoundingBox& bounds, khepri::scene::SceneObject& object)
+{
+    const auto id   = allocate_node();
+    auto&      leaf = m_nodes[id];
+    leaf.box        = enlarge(bounds);
+    leaf.bounds     = bounds;
+    leaf.height     = 0;
+    leaf.object     = &object;
+    insert_leaf(id);
+    ++m_size;
+    return id;
+}
+
+void SpatialIndex::remove(Id id)
+{
+    assert(id < m_nodes.size() && m_nodes[id].is_leaf() && m_nodes[id].height == 0);
+    remove_leaf(id);
+    free_node(id);
+    --m_size;
+}
+
+bool SpatialIndex::update(Id id, const BoundingBox& bounds)
+{
+    assert(id < m_nodes.size() && m_nodes[id].is_leaf() && m_nodes[id].height == 0);
+    auto& leaf  = m_nodes[id];
+    leaf.bounds = bounds;
+    if (leaf.box.contains(bounds)) {
+        return false;
+    }
+
+    remove_leaf(id);
+    m_nodes[id].box = enlarge(bounds);
+    insert_leaf(id);
+    return true;
+}
+
+SpatialIndex::BoundingBox SpatialIndex::enlarge(const BoundingBox& bounds) const noexcept
+{
+    // Leave room for movement in proportion to the object's size, but at least a small amount
+    // for point-like objects.
+    const float margin = std::max(bounds.radius() * m_margin, 1.0f);
+    return {{bounds.min.x - margin, bounds.min.y - margin, bounds.min.z - margin},
+            {bounds.max.x + margin, bounds.max.y + margin, bounds.max.z + margin}};
+}
+
+SpatialIndex::Id SpatialIndex::allocate_node()
+{
+    if (m_free_list == INVALID_ID) {
+        m_nodes.emplace_back();
+        return static_cast<Id>(m_nodes.size() - 1);
+    }
+    const auto id = m_free_list;
+    m_free_list   = m_nodes[id].parent;
+    m_nodes[id]   = {};
+    return id;
+}
+
+void SpatialIndex::free_node(Id id) noexcept
+{
+    m_nodes[id]        = {};
+    m_nodes[id].parent = m_free_list;
+    m_free_list        = id;
+}
+
+void SpatialIndex::insert_leaf(Id leaf)
+{
+    if (m_root == INVALID_ID) {
+        m_root               = leaf;
+        m_nodes[leaf].parent = INVALID_ID;
+        return;
+    }
+
+    // Find the best sibling by descending the tree, choosing the child that minimizes the
+    // increase in surface area of the tree.
+    const auto leaf_box = m_nodes[leaf].box;
+    Id         index    = m_root;
+    while (!m_nodes[index].is_leaf()) {
+        const auto& node     = m_nodes[index];
+        const float area     = node.box.half_area();
+        const float combined = combine(node.box, leaf_box).half_area();
+
+        // Cost of creating a new parent for this node and the new leaf
+        const float cost = 2 * combined;
+
+        // Minimum cost of pushing the leaf further down the tree
+        const float inheritance_cost = 2 * (combined - area);
+
+        const auto child_cost = [&](Id child) {
+            const auto& child_node = m_nodes[child];
+            const float new_area   = combine(child_node.box, leaf_box).half_area();
+            if (child_node.is_leaf()) {
+                return new_area + inheritance_cost;
+            }
+            return new_area - child_node.box.half_area() + inheritance_cost;
+        };
+
+        const float cost1 = child_cost(node.child1);
+        const float cost2 = child_cost(node.child2);
+        if (cost < cost1 && cost < cost2) {
+            break;
+        }
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    // Create a new parent for the sibling and the leaf
+    const Id sibling    = index;
+    const Id old_parent = m_nodes[sibling].parent;
+    const Id new_parent = allocate_node();
+    {
+        auto& parent  = m_nodes[new_parent];
+        parent.parent = old_parent;
+        parent.box    = combine(leaf_box, m_nodes[sibling].box);
+        parent.height = m_nodes[sibling].height + 1;
+        parent.child1 = sibling;
+        parent.child2 = leaf;
+    }
+    if (old_parent == INVALID_ID) {
+        m_root = new_parent;
+    } else if (m_nodes[old_parent].child1 == sibling) {
+        m_nodes[old_parent].child1 = new_parent;
+    } else {
+        m_nodes[old_parent].child2 = new_parent;
+    }
+    m_nodes[sibling].parent = new_parent;
+    m_nodes[leaf].parent    = new_parent;
+
+    // Walk back up the tree, fixing heights and boxes
+    for (index = new_parent; index != INVALID_ID; index = m_nodes[index].parent) {
+        index              = balance(index);
+        auto&       node   = m_nodes[index];
+        const auto& child1 = m_nodes[node.child1];
+        const auto& child2 = m_nodes[node.child2];
+        node.height        = 1 + std::max(child1.height, child2.height);
+        node.box           = combine(child1.box, child2.box);
+    }
+}
+
+void SpatialIndex::remove_leaf(Id leaf)
+{
+    if (leaf == m_root) {
+        m_root = INVALID_ID;
+        return;
+    }
+
+    const Id parent       = m_nodes[leaf].parent;
+    const Id grand_parent = m_nodes[parent].parent;
+    const Id sibling =
+        m_nodes[parent].child1 == leaf ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+    // Replace the parent by the sibling
+    m_nodes[sibling].parent = grand_parent;
+    free_node(parent);
+    if (grand_parent == INVALID_ID) {
+        m_root = sibling;
+        return;
+    }
+    if (m_nodes[grand_parent].child1 == parent) {
+        m_nodes[grand_parent].child1 = sibling;
+    } else {
+        m_nodes[grand_parent].child2 = sibling;
+    }
+
+    for (Id index = grand_parent; index != INVALID_ID; index = m_nodes[index].parent) {
+        index              = balance(index);
+        auto&       node   = m_nodes[index];
+        const auto& child1 = m_nodes[node.child1];
+        const auto& child2 = m_nodes[node.child2];
+        node.height        = 1 + std::max(child1.height, child2.height);
+        node.box           = combine(child1.box, child2.box);
+    }
+}
+
+SpatialIndex::Id SpatialIndex::balance(Id a_id)
+{
+    // Performs a left or right rotation if node A is imbalanced, and returns the new root of the
+    // subtree.
+    auto& a = m_nodes[a_id];
+    if (a.is_leaf() || a.height < 2) {
+        return a_id;
+    }
+
+    const Id  b_id = a.child1;
+    const Id  c_id = a.child2;
+    const int skew = m_nodes[c_id].height - m_nodes[b_id].height;
+    if (skew >= -1 && skew <= 1) {
+        return a_id;
+    }
+
+    // Rotate the taller child up
+    const bool rotate_c = skew > 0;
+    const Id   up_id    = rotate_c ? c_id : b_id;
+    const Id   other_id = rotate_c ? b_id : c_id;
+    auto&      up       = m_nodes[up_id];
+    const Id   f_id     = up.child1;
+    const Id   g_id     = up.child2;
+
+    // Swap A and the child
+    up.child1 = a_id;
+    up.parent = a.parent;
+    a.parent  = up_id;
+
+    // A's old parent should point to the child
+    if (up.parent == INVALID_ID) {
+        m_root = up_id;
+    } else if (m_nodes[up.parent].child1 == a_id) {
+        m_nodes[up.parent].child1 = up_id;
+    } else {
+        m_nodes[up.parent].child2 = up_id;
+    }
+
+    // Keep the taller grandchild under the child and move the other one to A
+    const bool keep_f = m_nodes[f_id].height > m_nodes[g_id].height;
+    const Id   keep   = keep_f ? f_id : g_id;
+    const Id   move   = keep_f ? g_id : f_id;
+
+    up.child2            = keep;
+    m_nodes[move].parent = a_id;
+    if (rotate_c) {
+        a.child2 = move;
+    } else {
+        a.child1 = move;
+    }
+
+    const auto& other = m_nodes[other_id];
+    const auto& moved = m_nodes[move];
+    a.box             = combine(other.box, moved.box);
+    a.height          = 1 + std::max(other.height, moved.height);
+    up.box            = combine(a.box, m_nodes[keep].box);
+    up.height         = 1 + std::max(a.height, m_nodes[keep].height);
+    return up_id;
+}
+
+} // namespace openglyph
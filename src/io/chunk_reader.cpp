@@ -39,6 +39,22 @@ bool ChunkReader::has_data() const
     return m_current->data;
 }
 
+long long ChunkReader::offset() const
+{
+    if (!has_chunk()) {
+        throw khepri::io::Error("end of chunk reached");
+    }
+    return m_current->start;
+}
+
+long long ChunkReader::size() const
+{
+    if (!has_chunk()) {
+        throw khepri::io::Error("end of chunk reached");
+    }
+    return m_current->end - m_current->start;
+}
+
 std::vector<std::uint8_t> ChunkReader::read_data()
 {
     if (!has_data()) {
@@ -0,0 +1,141 @@
+#include <openglyph/io/mapped_file.hpp>
+
+#include <khepri/io/exceptions.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace openglyph::io {
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw khepri::io::Error("unable to open file");
+    }
+
+    LARGE_INTEGER size;
+    if (GetFileSizeEx(file, &size) == 0) {
+        CloseHandle(file);
+        throw khepri::io::Error("unable to get file size");
+    }
+    m_file = file;
+    m_size = static_cast<std::size_t>(size.QuadPart);
+    if (m_size == 0) {
+        // Empty files cannot be mapped
+        return;
+    }
+
+    m_mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping == nullptr) {
+        CloseHandle(file);
+        throw khepri::io::Error("unable to map file");
+    }
+
+    m_data = static_cast<const std::uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (m_data == nullptr) {
+        CloseHandle(m_mapping);
+        CloseHandle(file);
+        throw khepri::io::Error("unable to map file");
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data != nullptr) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mapping != nullptr) {
+        CloseHandle(m_mapping);
+    }
+    CloseHandle(m_file);
+}
+#else
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw khepri::io::Error("unable to open file");
+    }
+
+    struct stat st
+    {};
+    if (::fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw khepri::io::Error("unable to get file size");
+    }
+    m_size = static_cast<std::size_t>(st.st_size);
+    if (m_size == 0) {
+        // Empty files cannot be mapped
+        ::close(fd);
+        return;
+    }
+
+    // The mapping keeps its own reference to the file
+    void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        throw khepri::io::Error("unable to map file");
+    }
+    m_data = static_cast<const std::uint8_t*>(data);
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_data != nullptr) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+        ::munmap(const_cast<std::uint8_t*>(m_data), m_size);
+    }
+}
+#endif
+
+std::size_t MemoryStream::read(void* buffer, std::size_t count)
+{
+    count = std::min(count, m_data.size() - m_pos);
+    std::memcpy(buffer, m_data.data() + m_pos, count);
+    m_pos += count;
+    return count;
+}
+
+std::size_t MemoryStream::write(const void* /*buffer*/, std::size_t /*count*/)
+{
+    throw khepri::io::Error("stream is not writable");
+}
+
+long long MemoryStream::seek(long long offset, khepri::io::SeekOrigin origin)
+{
+    long long base = 0;
+    switch (origin) {
+    case khepri::io::SeekOrigin::begin:
+        break;
+    case khepri::io::SeekOrigin::current:
+        base = static_cast<long long>(m_pos);
+        break;
+    case khepri::io::SeekOrigin::end:
+        base = static_cast<long long>(m_data.size());
+        break;
+    }
+
+    const auto pos = base + offset;
+    if (pos < 0 || pos > static_cast<long long>(m_data.size())) {
+        throw khepri::io::Error("seek out of range");
+    }
+    m_pos = static_cast<std::size_t>(pos);
+    return pos;
+}
+
+} // namespace openglyph::io
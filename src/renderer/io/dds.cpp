@@ -0,0 +1,288 @@
+#include <khepri/io/exceptions.hpp>
+#include <khepri/renderer/io/texture.hpp>
+#include <openglyph/io/mapped_file.hpp>
+#include <openglyph/renderer/io/dds.hpp>
+
+#include <algorithm>
+
+namespace openglyph::renderer::io {
+namespace {
+
+constexpr std::uint32_t DDS_MAGIC         = 0x20534444; // "DDS "
+constexpr std::size_t   DDS_HEADER_SIZE   = 4 + 124;
+constexpr std::size_t   DX10_HEADER_SIZE  = 20;
+constexpr std::size_t   OFFSET_FLAGS      = 8;
+constexpr std::size_t   OFFSET_HEIGHT     = 12;
+constexpr std::size_t   OFFSET_WIDTH      = 16;
+constexpr std::size_t   OFFSET_PITCH      = 20;
+constexpr std::size_t   OFFSET_DEPTH      = 24;
+constexpr std::size_t   OFFSET_MIP_COUNT  = 28;
+constexpr std::size_t   OFFSET_PF_FLAGS   = 80;
+constexpr std::size_t   OFFSET_PF_FOURCC  = 84;
+constexpr std::size_t   OFFSET_PF_BITS    = 88;
+constexpr std::size_t   OFFSET_CAPS2      = 112;
+constexpr std::size_t   OFFSET_DXGI       = DDS_HEADER_SIZE;
+constexpr std::size_t   OFFSET_DIMENSION  = DDS_HEADER_SIZE + 4;
+constexpr std::size_t   OFFSET_MISC_FLAG  = DDS_HEADER_SIZE + 8;
+constexpr std::size_t   OFFSET_ARRAY_SIZE = DDS_HEADER_SIZE + 12;
+
+constexpr std::uint32_t DDSD_PITCH            = 0x8;
+constexpr std::uint32_t DDSD_MIPMAPCOUNT      = 0x20000;
+constexpr std::uint32_t DDSD_LINEARSIZE       = 0x80000;
+constexpr std::uint32_t DDSD_DEPTH            = 0x800000;
+constexpr std::uint32_t DDPF_FOURCC           = 0x4;
+constexpr std::uint32_t DDSCAPS2_CUBEMAP      = 0x200;
+constexpr std::uint32_t DDSCAPS2_ALL_FACES    = 0xFC00;
+constexpr std::uint32_t DDSCAPS2_VOLUME       = 0x200000;
+constexpr std::uint32_t DX10_TEXTURE_3D       = 4;
+constexpr std::uint32_t DX10_MISC_TEXTURECUBE = 0x4;
+
+constexpr std::uint32_t fourcc(const char (&code)[5]) noexcept
+{
+    return static_cast<std::uint32_t>(code[0]) | (static_cast<std::uint32_t>(code[1]) << 8) |
+           (static_cast<std::uint32_t>(code[2]) << 16) |
+           (static_cast<std::uint32_t>(code[3]) << 24);
+}
+
+std::uint32_t get_uint(const std::vector<std::uint8_t>& data, std::size_t offset) noexcept
+{
+    return static_cast<std::uint32_t>(data[offset]) |
+           (static_cast<std::uint32_t>(data[offset + 1]) << 8) |
+           (static_cast<std::uint32_t>(data[offset + 2]) << 16) |
+           (static_cast<std::uint32_t>(data[offset + 3]) << 24);
+}
+
+void set_uint(std::vector<std::uint8_t>& data, std::size_t offset, std::uint32_t value) noexcept
+{
+    for (std::size_t i = 0; i < 4; ++i) {
+        data[offset + i] = static_cast<std::uint8_t>(value >> (i * 8));
+    }
+}
+
+// Determines the block size or pixel size of a DXGI format
+bool dxgi_format_size(std::uint32_t format, DdsLayout& layout) noexcept
+{
+    // Block-compressed formats: BC1 and BC4 use 8 bytes per block, the others 16
+    if ((format >= 70 && format <= 72) || (format >= 79 && format <= 81)) {
+        layout.block_size = 8;
+    } else if ((format >= 73 && format <= 78) || (format >= 82 && format <= 84) ||
+               (format >= 94 && format <= 99)) {
+        layout.block_size = 16;
+    } else if (format >= 1 && format <= 4) {
+        layout.bits_per_pixel = 128;
+    } else if (format >= 5 && format <= 8) {
+        layout.bits_per_pixel = 96;
+    } else if (format >= 9 && format <= 22) {
+        layout.bits_per_pixel = 64;
+    } else if ((format >= 23 && format <= 47) || (format >= 87 && format <= 93)) {
+        layout.bits_per_pixel = 32;
+    } else if ((format >= 48 && format <= 59) || format == 85 || format == 86 || format == 115) {
+        layout.bits_per_pixel = 16;
+    } else if (format >= 60 && format <= 65) {
+        layout.bits_per_pixel = 8;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Determines the block size or pixel size of a legacy (non-DX10) pixel format
+bool legacy_format_size(const std::vector<std::uint8_t>& header, DdsLayout& layout) noexcept
+{
+    if ((get_uint(header, OFFSET_PF_FLAGS) & DDPF_FOURCC) == 0) {
+        const auto bits = get_uint(header, OFFSET_PF_BITS);
+        if (bits == 0 || bits % 8 != 0) {
+            return false;
+        }
+        layout.bits_per_pixel = bits;
+        return true;
+    }
+
+    switch (get_uint(header, OFFSET_PF_FOURCC)) {
+    case fourcc("DXT1"):
+    case fourcc("ATI1"):
+    case fourcc("BC4U"):
+    case fourcc("BC4S"):
+        layout.block_size = 8;
+        return true;
+    case fourcc("DXT2"):
+    case fourcc("DXT3"):
+    case fourcc("DXT4"):
+    case fourcc("DXT5"):
+    case fourcc("ATI2"):
+    case fourcc("BC5U"):
+    case fourcc("BC5S"):
+        layout.block_size = 16;
+        return true;
+    case 111: // D3DFMT_R16F
+        layout.bits_per_pixel = 16;
+        return true;
+    case 112: // D3DFMT_G16R16F
+    case 114: // D3DFMT_R32F
+        layout.bits_per_pixel = 32;
+        return true;
+    case 36:  // D3DFMT_A16B16G16R16
+    case 110: // D3DFMT_Q16W16V16U16
+    case 113: // D3DFMT_A16B16G16R16F
+    case 115: // D3DFMT_G32R32F
+        layout.bits_per_pixel = 64;
+        return true;
+    case 116: // D3DFMT_A32B32G32R32F
+        layout.bits_per_pixel = 128;
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Size of a single row of pixels or blocks
+std::size_t row_pitch(const DdsLayout& layout, unsigned long width) noexcept
+{
+    if (layout.block_size != 0) {
+        return std::max<std::size_t>(1, (width + 3) / 4) * layout.block_size;
+    }
+    return (width * layout.bits_per_pixel + 7) / 8;
+}
+
+// Size of a 2D image, i.e. a single depth slice of a mip level
+std::size_t image_size(const DdsLayout& layout, unsigned long width, unsigned long height) noexcept
+{
+    const auto rows = (layout.block_size != 0) ? std::max<std::size_t>(1, (height + 3) / 4)
+                                               : static_cast<std::size_t>(height);
+    return row_pitch(layout, width) * rows;
+}
+
+std::size_t slice_size(const DdsLayout& layout) noexcept
+{
+    std::size_t size = 0;
+    for (const auto mip_size : layout.mip_sizes) {
+        size += mip_size;
+    }
+    return size;
+}
+
+void read_exactly(khepri::io::Stream& stream, void* buffer, std::size_t count)
+{
+    if (stream.read(buffer, count) != count) {
+        throw khepri::io::InvalidFormatError();
+    }
+}
+
+} // namespace
+
+std::optional<DdsLayout> read_dds_layout(khepri::io::Stream& stream)
+{
+    DdsLayout layout;
+    layout.header.resize(DDS_HEADER_SIZE);
+    if (stream.read(layout.header.data(), DDS_HEADER_SIZE) != DDS_HEADER_SIZE ||
+        get_uint(layout.header, 0) != DDS_MAGIC) {
+        return {};
+    }
+
+    const auto flags = get_uint(layout.header, OFFSET_FLAGS);
+    const auto caps2 = get_uint(layout.header, OFFSET_CAPS2);
+
+    layout.width  = get_uint(layout.header, OFFSET_WIDTH);
+    layout.height = get_uint(layout.header, OFFSET_HEIGHT);
+    if ((flags & DDSD_MIPMAPCOUNT) != 0) {
+        layout.mip_levels = std::max<std::uint32_t>(get_uint(layout.header, OFFSET_MIP_COUNT), 1);
+    }
+
+    bool volume = false;
+    if ((get_uint(layout.header, OFFSET_PF_FLAGS) & DDPF_FOURCC) != 0 &&
+        get_uint(layout.header, OFFSET_PF_FOURCC) == fourcc("DX10")) {
+        layout.header.resize(DDS_HEADER_SIZE + DX10_HEADER_SIZE);
+        if (stream.read(layout.header.data() + DDS_HEADER_SIZE, DX10_HEADER_SIZE) !=
+                DX10_HEADER_SIZE ||
+            !dxgi_format_size(get_uint(layout.header, OFFSET_DXGI), layout)) {
+            return {};
+        }
+        const auto cube = (get_uint(layout.header, OFFSET_MISC_FLAG) & DX10_MISC_TEXTURECUBE) != 0;
+        volume          = get_uint(layout.header, OFFSET_DIMENSION) == DX10_TEXTURE_3D;
+        layout.slices   = std::max<std::uint32_t>(get_uint(layout.header, OFFSET_ARRAY_SIZE), 1) *
+                        (cube ? 6 : 1);
+    } else {
+        if (!legacy_format_size(layout.header, layout)) {
+            return {};
+        }
+        if ((caps2 & DDSCAPS2_CUBEMAP) != 0) {
+            if ((caps2 & DDSCAPS2_ALL_FACES) != DDSCAPS2_ALL_FACES) {
+                // Partial cube maps are not supported
+                return {};
+            }
+            layout.slices = 6;
+        }
+        volume = (caps2 & DDSCAPS2_VOLUME) != 0;
+    }
+
+    if (volume && (flags & DDSD_DEPTH) != 0) {
+        layout.depth = std::max<std::uint32_t>(get_uint(layout.header, OFFSET_DEPTH), 1);
+    }
+
+    if (layout.width == 0 || layout.height == 0 || layout.mip_levels > 32) {
+        return {};
+    }
+
+    layout.mip_sizes.resize(layout.mip_levels);
+    for (unsigned int mip = 0; mip < layout.mip_levels; ++mip) {
+        const auto width      = std::max(layout.width >> mip, 1ul);
+        const auto height     = std::max(layout.height >> mip, 1ul);
+        const auto depth      = std::max(layout.depth >> mip, 1ul);
+        layout.mip_sizes[mip] = image_size(layout, width, height) * depth;
+    }
+
+    // Make sure the file actually contains all mip levels
+    const auto end = stream.seek(0, khepri::io::SeekOrigin::end);
+    if (end < 0 || static_cast<std::size_t>(end) <
+                       layout.header.size() + slice_size(layout) * layout.slices) {
+        return {};
+    }
+    return layout;
+}
+
+khepri::renderer::TextureDesc load_dds_mips(khepri::io::Stream& stream, const DdsLayout& layout,
+                                            unsigned int top_mip)
+{
+    top_mip = std::min(top_mip, layout.mip_levels - 1);
+
+    const auto width  = std::max(layout.width >> top_mip, 1ul);
+    const auto height = std::max(layout.height >> top_mip, 1ul);
+
+    std::size_t skipped = 0;
+    for (unsigned int mip = 0; mip < top_mip; ++mip) {
+        skipped += layout.mip_sizes[mip];
+    }
+    const auto full_size = slice_size(layout);
+    const auto read_size = full_size - skipped;
+
+    // Build a DDS file in memory that contains only the requested mip levels, with the headers
+    // patched to match, and let the regular texture loader parse that.
+    std::vector<std::uint8_t> data(layout.header);
+    const auto                flags = get_uint(data, OFFSET_FLAGS);
+    set_uint(data, OFFSET_FLAGS, flags | DDSD_MIPMAPCOUNT);
+    set_uint(data, OFFSET_WIDTH, static_cast<std::uint32_t>(width));
+    set_uint(data, OFFSET_HEIGHT, static_cast<std::uint32_t>(height));
+    set_uint(data, OFFSET_MIP_COUNT, layout.mip_levels - top_mip);
+    if (layout.depth > 1) {
+        set_uint(data, OFFSET_DEPTH,
+                 static_cast<std::uint32_t>(std::max(layout.depth >> top_mip, 1ul)));
+    }
+    if ((flags & DDSD_LINEARSIZE) != 0) {
+        set_uint(data, OFFSET_PITCH, static_cast<std::uint32_t>(image_size(layout, width, height)));
+    } else if ((flags & DDSD_PITCH) != 0) {
+        set_uint(data, OFFSET_PITCH, static_cast<std::uint32_t>(row_pitch(layout, width)));
+    }
+
+    const auto header_size = data.size();
+    data.resize(header_size + read_size * layout.slices);
+    for (unsigned int slice = 0; slice < layout.slices; ++slice) {
+        stream.seek(static_cast<long long>(layout.header.size() + slice * full_size + skipped),
+                    khepri::io::SeekOrigin::begin);
+        read_exactly(stream, data.data() + header_size + slice * read_size, read_size);
+    }
+
+    openglyph::io::MemoryStream memory_stream(data);
+    return khepri::renderer::io::load_texture(memory_stream);
+}
+
+} // namespace openglyph::renderer::io
@@ -108,7 +108,7 @@ namespace {
 auto load_material(const openglyph::XmlParser::Node& node)
 {
     struct MaterialDesc material_desc;
-    material_desc.name             = require_attribute(node, "Name");
+    material_desc.name             = Symbol(require_attribute(node, "Name"));
     material_desc.alpha_blend_mode = openglyph::parse<MaterialDesc::AlphaBlendMode>(
         optional_attribute(node, "AlphaBlend", "none"));
 
@@ -126,7 +126,7 @@ auto load_material(const openglyph::XmlParser::Node& node)
             material_desc.shader = propnode.value();
         } else if (propnode.name() == "Param") {
             MaterialDesc::Property property;
-            property.name = require_attribute(propnode, "Name");
+            property.name = Symbol(require_attribute(propnode, "Name"));
             auto type     = openglyph::parse<PropertyType>(require_attribute(propnode, "Type"));
             switch (type) {
             case PropertyType::integer:
@@ -5,10 +5,13 @@
 #include <khepri/utility/string.hpp>
 #include <openglyph/io/chunk_reader.hpp>
 #include <openglyph/renderer/io/model.hpp>
+#include <openglyph/renderer/vertex_compression.hpp>
 
 #include <algorithm>
 #include <charconv>
+#include <memory>
 #include <tuple>
+#include <utility>
 
 using Model = openglyph::renderer::Model;
 
@@ -177,7 +180,7 @@ auto parse_mesh_name(std::string_view name)
         }
     }
 
-    return std::make_tuple(std::string(name), lod, alt);
+    return std::make_tuple(Symbol(name), lod, alt);
 }
 
 auto read_submesh(ChunkReader& reader)
@@ -246,7 +249,7 @@ Model::Material::Param read_material_param(gsl::span<const std::uint8_t> data)
     for (; reader.has_chunk(); reader.next()) {
         switch (reader.id()) {
         case 1:
-            param.name = as_string(reader.read_data());
+            param.name = Symbol(as_string(reader.read_data()));
             break;
         case 2:
             param.value = read_material_param_value<T>(reader.read_data());
@@ -258,7 +261,7 @@ Model::Material::Param read_material_param(gsl::span<const std::uint8_t> data)
 
 auto read_shader_info(ChunkReader& reader)
 {
-    std::string                         name;
+    Symbol                              name;
     std::vector<Model::Material::Param> params;
 
     for (; reader.has_chunk(); reader.next()) {
@@ -266,7 +269,7 @@ auto read_shader_info(ChunkReader& reader)
         switch (id) {
         case ChunkId::shader_name:
             verify(reader.has_data());
-            name = as_string(reader.read_data());
+            name = Symbol(as_string(reader.read_data()));
             break;
         case ChunkId::shader_param_int:
             verify(reader.has_data());
@@ -293,7 +296,31 @@ auto read_shader_info(ChunkReader& reader)
     return std::make_tuple(std::move(name), std::move(params));
 }
 
-Model::Mesh read_mesh(ChunkReader& reader)
+// Reads a mesh info chunk into the mesh's material count, bounding box and visibility
+auto read_mesh_info(gsl::span<const std::uint8_t> data)
+{
+    khepri::io::Deserializer d(data);
+    const std::size_t        material_count = d.read<std::uint32_t>();
+    renderer::BoundingBox    bounding_box;
+    bounding_box.min = d.read<khepri::Vector3f>();
+    bounding_box.max = d.read<khepri::Vector3f>();
+    d.read<std::uint32_t>();
+    const bool visible = (d.read<std::uint32_t>() == 0);
+    return std::make_tuple(material_count, bounding_box, visible);
+}
+
+// Reads a submesh chunk's contents into a material's vertices and indices
+void read_geometry(ChunkReader& reader, Model::Material& mat, Model::VertexFormat vertex_format)
+{
+    std::tie(mat.vertices, mat.indices) = read_submesh(reader);
+    if (vertex_format == Model::VertexFormat::compact) {
+        mat.compact_vertices.resize(mat.vertices.size());
+        openglyph::renderer::compress_vertices(mat.vertices, mat.compact_vertices);
+        mat.vertices = {};
+    }
+}
+
+Model::Mesh read_mesh(ChunkReader& reader, Model::VertexFormat vertex_format)
 {
     Model::Mesh mesh;
     int         submesh_idx = 0;
@@ -309,13 +336,10 @@ Model::Mesh read_mesh(ChunkReader& reader)
 
         case ChunkId::mesh_info: {
             verify(reader.has_data());
-            const auto               data = reader.read_data();
-            khepri::io::Deserializer d(data);
-            mesh.materials.resize(d.read<std::uint32_t>());
-            d.read<khepri::Vector3f>();
-            d.read<khepri::Vector3f>();
-            d.read<std::uint32_t>();
-            mesh.visible = (d.read<std::uint32_t>() == 0);
+            std::size_t material_count = 0;
+            std::tie(material_count, mesh.bounding_box, mesh.visible) =
+                read_mesh_info(reader.read_data());
+            mesh.materials.resize(material_count);
             break;
         }
 
@@ -324,7 +348,7 @@ Model::Mesh read_mesh(ChunkReader& reader)
             verify(submesh_idx < mesh.materials.size());
             auto& mat = mesh.materials[submesh_idx];
             reader.open();
-            std::tie(mat.vertices, mat.indices) = read_submesh(reader);
+            read_geometry(reader, mat, vertex_format);
             reader.close();
             submesh_idx++;
             break;
@@ -345,7 +369,7 @@ Model::Mesh read_mesh(ChunkReader& reader)
 }
 } // namespace
 
-Model read_model(khepri::io::Stream& stream)
+Model read_model(khepri::io::Stream& stream, Model::VertexFormat vertex_format)
 {
     Model       model;
     ChunkReader reader(stream);
@@ -354,7 +378,7 @@ Model read_model(khepri::io::Stream& stream)
         case ChunkId::mesh:
             verify(!reader.has_data());
             reader.open();
-            model.meshes.push_back(read_mesh(reader));
+            model.meshes.push_back(read_mesh(reader, vertex_format));
             reader.close();
             break;
         }
@@ -363,4 +387,120 @@ Model read_model(khepri::io::Stream& stream)
     return model;
 }
 
+ModelView::ModelView(const std::filesystem::path& path, Model::VertexFormat vertex_format)
+    : m_file(std::make_unique<MappedFile>(path))
+    , m_data(m_file->data())
+    , m_vertex_format(vertex_format)
+{
+    MemoryStream stream(m_data);
+    ChunkReader  reader(stream);
+    index(reader);
+}
+
+ModelView::ModelView(gsl::span<const std::uint8_t> data, Model::VertexFormat vertex_format)
+    : m_data(data), m_vertex_format(vertex_format)
+{
+    MemoryStream stream(m_data);
+    ChunkReader  reader(stream);
+    index(reader);
+}
+
+ModelView::~ModelView() = default;
+
+const Model::Material& ModelView::material(std::size_t mesh, std::size_t material)
+{
+    auto& submesh = m_meshes.at(mesh).submeshes.at(material);
+    shader(mesh, material);
+    if (!submesh.geometry_decoded) {
+        if (!submesh.geometry.empty()) {
+            MemoryStream stream(submesh.geometry);
+            ChunkReader  reader(stream);
+            read_geometry(reader, submesh.material, m_vertex_format);
+        }
+        submesh.geometry_decoded = true;
+    }
+    return submesh.material;
+}
+
+const Model::Material& ModelView::shader(std::size_t mesh, std::size_t material)
+{
+    auto& submesh = m_meshes.at(mesh).submeshes.at(material);
+    if (!submesh.shader_decoded) {
+        if (!submesh.shader.empty()) {
+            MemoryStream stream(submesh.shader);
+            ChunkReader  reader(stream);
+            std::tie(submesh.material.name, submesh.material.params) = read_shader_info(reader);
+        }
+        submesh.shader_decoded = true;
+    }
+    return submesh.material;
+}
+
+bool ModelView::is_decoded(std::size_t mesh, std::size_t material) const
+{
+    const auto& submesh = m_meshes.at(mesh).submeshes.at(material);
+    return submesh.shader_decoded && submesh.geometry_decoded;
+}
+
+void ModelView::index(ChunkReader& reader)
+{
+    for (; reader.has_chunk(); reader.next()) {
+        switch (reader.id()) {
+        case ChunkId::mesh:
+            verify(!reader.has_data());
+            reader.open();
+            index_mesh(reader);
+            reader.close();
+            break;
+        }
+    }
+    if (m_meshes.empty()) {
+        // An empty or truncated file; a model without meshes is of no use to the renderer
+        throw khepri::io::Error("model contains no meshes");
+    }
+}
+
+void ModelView::index_mesh(ChunkReader& reader)
+{
+    auto& mesh        = m_meshes.emplace_back();
+    int   submesh_idx = 0;
+    int   shader_idx  = 0;
+
+    // Returns the contents of the current chunk, without reading them
+    const auto contents = [&] {
+        return m_data.subspan(static_cast<std::size_t>(reader.offset()),
+                              static_cast<std::size_t>(reader.size()));
+    };
+
+    for (; reader.has_chunk(); reader.next()) {
+        switch (reader.id()) {
+        case ChunkId::mesh_name:
+            verify(reader.has_data());
+            std::tie(mesh.info.name, mesh.info.lod, mesh.info.alt) =
+                parse_mesh_name(as_string(reader.read_data()));
+            break;
+
+        case ChunkId::mesh_info: {
+            verify(reader.has_data());
+            std::tie(mesh.info.material_count, mesh.info.bounding_box, mesh.info.visible) =
+                read_mesh_info(reader.read_data());
+            mesh.submeshes.resize(mesh.info.material_count);
+            break;
+        }
+
+        case ChunkId::submesh:
+            verify(!reader.has_data());
+            verify(submesh_idx < mesh.submeshes.size());
+            mesh.submeshes[submesh_idx++].geometry = contents();
+            break;
+
+        case ChunkId::shader_info:
+            verify(!reader.has_data());
+            verify(shader_idx < mesh.submeshes.size());
+            mesh.submeshes[shader_idx++].shader = contents();
+            break;
+        }
+    }
+}
+
 } // namespace openglyph::io
@@ -1,4 +1,9 @@
 #include <openglyph/renderer/material_store.hpp>
+#include <openglyph/utility/thread_pool.hpp>
+
+#include <algorithm>
+#include <set>
+#include <vector>
 
 namespace openglyph::renderer {
 namespace {
@@ -15,31 +20,149 @@ Overloaded(Ts...) -> Overloaded<Ts...>;
 void MaterialStore::register_materials(
     gsl::span<const openglyph::renderer::MaterialDesc> material_descs)
 {
+    if (m_mode == Mode::parallel) {
+        register_materials_parallel(material_descs);
+        return;
+    }
+
     for (const auto& desc : material_descs) {
-        khepri::renderer::MaterialDesc info;
-        info.cull_mode        = khepri::renderer::MaterialDesc::CullMode::front;
-        info.alpha_blend_mode = desc.alpha_blend_mode;
-        info.depth_buffer     = desc.depth_buffer;
-        info.shader           = m_shader_loader(desc.shader);
-        for (const auto& property : desc.properties) {
-            khepri::renderer::MaterialDesc::Property prop;
-            prop.name = property.name;
-            std::visit(Overloaded{[&](const std::string& str) {
-                                      prop.default_value = m_texture_loader(str);
-                                  },
-                                  [&](const auto& val) { prop.default_value = val; }},
-                       property.default_value);
-            info.properties.push_back(std::move(prop));
+        auto* entry = add_entry(desc);
+        if (entry == nullptr) {
+            continue;
+        }
+        if (m_mode == Mode::lazy) {
+            entry->desc = desc;
+        } else {
+            entry->material = create_material(desc, m_shader_loader, m_texture_loader);
         }
+    }
+}
+
+khepri::renderer::Material* MaterialStore::get(Symbol name)
+{
+    const auto it = m_materials.find(name);
+    if (it == m_materials.end()) {
+        return nullptr;
+    }
 
-        m_materials.emplace(desc.name, m_renderer.create_material(info));
+    auto& entry = it->second;
+    if (entry.desc) {
+        entry.material = create_material(*entry.desc, m_shader_loader, m_texture_loader);
+        entry.desc.reset();
     }
+    return entry.material.get();
 }
 
-khepri::renderer::Material* MaterialStore::get(std::string_view name) const noexcept
+const MaterialInfo* MaterialStore::info(Symbol name) const noexcept
 {
     const auto it = m_materials.find(name);
-    return (it != m_materials.end()) ? it->second.get() : nullptr;
+    return it != m_materials.end() ? &it->second.info : nullptr;
+}
+
+MaterialStore::Entry* MaterialStore::add_entry(const MaterialDesc& desc)
+{
+    const auto material_index = static_cast<std::uint32_t>(m_materials.size());
+    const auto [it, inserted] = m_materials.try_emplace(desc.name);
+    if (!inserted) {
+        return nullptr;
+    }
+
+    auto&      info         = it->second.info;
+    const auto shader_index = static_cast<std::uint32_t>(m_shader_indices.size());
+    info.sort_info          = {
+        desc.alpha_blend_mode != MaterialDesc::AlphaBlendMode::none,
+        m_shader_indices.try_emplace(Symbol(desc.shader), shader_index).first->second,
+        material_index};
+    info.properties.reserve(desc.properties.size());
+    for (const auto& property : desc.properties) {
+        info.properties.push_back(property.name);
+    }
+    return &it->second;
+}
+
+void MaterialStore::register_materials_parallel(
+    gsl::span<const openglyph::renderer::MaterialDesc> material_descs)
+{
+    using NameSet = std::set<std::string_view, khepri::CaseInsensitiveLess>;
+
+    // Collect the unique shaders and textures that are referenced by the materials
+    NameSet shader_set;
+    NameSet texture_set;
+    for (const auto& desc : material_descs) {
+        shader_set.insert(desc.shader);
+        for (const auto& property : desc.properties) {
+            if (const auto* texture = std::get_if<std::string>(&property.default_value)) {
+                texture_set.insert(*texture);
+            }
+        }
+    }
+
+    // Load them in parallel. Shaders come first, since they typically take the longest.
+    const std::vector<std::string_view>     shader_names(shader_set.begin(), shader_set.end());
+    const std::vector<std::string_view>     texture_names(texture_set.begin(), texture_set.end());
+    std::vector<khepri::renderer::Shader*>  shaders(shader_names.size());
+    std::vector<khepri::renderer::Texture*> textures(texture_names.size());
+
+    const auto& load = [&](std::size_t index) {
+        if (index < shader_names.size()) {
+            shaders[index] = m_shader_loader(shader_names[index]);
+        } else {
+            index -= shader_names.size();
+            textures[index] = m_texture_loader(texture_names[index]);
+        }
+    };
+    const auto count = shader_names.size() + texture_names.size();
+    if (m_thread_pool != nullptr) {
+        m_thread_pool->parallel_for(count, load);
+    } else {
+        for (std::size_t index = 0; index < count; ++index) {
+            load(index);
+        }
+    }
+
+    // Assemble the materials from the loaded shaders and textures
+    const auto& lookup = [](const auto& names, const auto& objects, std::string_view name) {
+        const auto it = std::lower_bound(names.begin(), names.end(), name,
+                                         khepri::CaseInsensitiveLess{});
+        return (it != names.end() && khepri::case_insensitive_equals(*it, name))
+                   ? objects[it - names.begin()]
+                   : nullptr;
+    };
+    const Loader<khepri::renderer::Shader> shader_loader = [&](std::string_view name) {
+        return lookup(shader_names, shaders, name);
+    };
+    const Loader<khepri::renderer::Texture> texture_loader = [&](std::string_view name) {
+        return lookup(texture_names, textures, name);
+    };
+
+    for (const auto& desc : material_descs) {
+        if (auto* entry = add_entry(desc)) {
+            entry->material = create_material(desc, shader_loader, texture_loader);
+        }
+    }
+}
+
+std::unique_ptr<khepri::renderer::Material>
+MaterialStore::create_material(const openglyph::renderer::MaterialDesc& desc,
+                               const Loader<khepri::renderer::Shader>&  shader_loader,
+                               const Loader<khepri::renderer::Texture>& texture_loader)
+{
+    khepri::renderer::MaterialDesc info;
+    info.cull_mode        = khepri::renderer::MaterialDesc::CullMode::front;
+    info.alpha_blend_mode = desc.alpha_blend_mode;
+    info.depth_buffer     = desc.depth_buffer;
+    info.shader           = shader_loader(desc.shader);
+    for (const auto& property : desc.properties) {
+        khepri::renderer::MaterialDesc::Property prop;
+        prop.name = std::string(property.name.str());
+        std::visit(Overloaded{[&](const std::string& str) {
+                                  prop.default_value = texture_loader(str);
+                              },
+                              [&](const auto& val) { prop.default_value = val; }},
+                   property.default_value);
+        info.properties.push_back(std::move(prop));
+    }
+    return m_renderer.create_material(info);
 }
 
 } // namespace openglyph::renderer
@@ -1,55 +1,542 @@
 #include <khepri/utility/string.hpp>
 #include <openglyph/renderer/model_creator.hpp>
+#include <openglyph/renderer/vertex_compression.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <type_traits>
+#include <variant>
 
 namespace openglyph::renderer {
+namespace {
+
+// Orders material parameters by their slot
+void sort_by_slot(std::vector<RenderModel::Mesh::Param>& params,
+                  std::vector<std::uint32_t>&            slots)
+{
+    std::vector<std::size_t> order(params.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](std::size_t i1, std::size_t i2) { return slots[i1] < slots[i2]; });
+
+    std::vector<RenderModel::Mesh::Param> sorted_params;
+    std::vector<std::uint32_t>            sorted_slots;
+    sorted_params.reserve(params.size());
+    sorted_slots.reserve(slots.size());
+    for (const auto index : order) {
+        sorted_params.push_back(std::move(params[index]));
+        sorted_slots.push_back(slots[index]);
+    }
+    params = std::move(sorted_params);
+    slots  = std::move(sorted_slots);
+}
+
+// Maximum number of triangles in a model's occluder. Models whose most detailed meshes have more
+// triangles are too expensive to rasterize on the CPU and are not used as occluders.
+constexpr std::size_t MAX_OCCLUDER_TRIANGLES = 2048;
+
+// Returns true if a mesh belongs in its model's occluder: the most detailed variant of a visible,
+// opaque mesh. Less detailed variants are simplifications that may bulge outside the model's
+// surface.
+bool is_occluder(const std::vector<RenderModel::Mesh>& meshes, std::size_t index)
+{
+    const auto& mesh = meshes[index];
+    if (!mesh.visible ||
+        (mesh.material_info != nullptr && mesh.material_info->sort_info.translucent)) {
+        return false;
+    }
+    return std::none_of(meshes.begin(), meshes.end(), [&](const auto& other) {
+        return other.name == mesh.name && other.alt == mesh.alt && other.lod > mesh.lod;
+    });
+}
+
+// Builds the occluder of a model from the drawn geometry of its occluder meshes, or returns
+// nothing if it is too large. Meshes whose geometry is not loaded yet (see ModelStreamer) add
+// nothing.
+std::optional<RenderModel::Occluder> create_occluder(const std::vector<RenderModel::Mesh>&  meshes,
+                                                     const std::vector<const Model::Mesh*>& sources)
+{
+    RenderModel::Occluder occluder;
+    for (std::size_t i = 0; i < meshes.size(); ++i) {
+        if (is_occluder(meshes, i) &&
+            !ModelCreator::add_to_occluder(occluder, sources[i]->materials[0])) {
+            return {};
+        }
+    }
+    return occluder;
+}
+
+// Returns the number of vertices of a material, in either form
+std::size_t vertex_count(const Model::Material& material) noexcept
+{
+    return material.vertices.size() + material.compact_vertices.size();
+}
+
+// Maximum number of vertices in a mesh, so that they can be indexed with Model::Index
+constexpr std::size_t MAX_MESH_VERTICES = std::size_t{std::numeric_limits<Model::Index>::max()} + 1;
+
+// Returns true if two sets of material parameters are identical
+bool equal_params(const std::vector<Model::Material::Param>& params1,
+                  const std::vector<Model::Material::Param>& params2)
+{
+    const auto equal_values = [](const auto& v1, const auto& v2) {
+        using T = std::decay_t<decltype(v1)>;
+        if constexpr (!std::is_same_v<T, std::decay_t<decltype(v2)>>) {
+            return false;
+        } else if constexpr (std::is_same_v<T, khepri::Vector3f>) {
+            return v1.x == v2.x && v1.y == v2.y && v1.z == v2.z;
+        } else if constexpr (std::is_same_v<T, khepri::Vector4f>) {
+            return v1.x == v2.x && v1.y == v2.y && v1.z == v2.z && v1.w == v2.w;
+        } else {
+            return v1 == v2;
+        }
+    };
+    return std::equal(params1.begin(), params1.end(), params2.begin(), params2.end(),
+                      [&](const auto& p1, const auto& p2) {
+                          return p1.name == p2.name && std::visit(equal_values, p1.value, p2.value);
+                      });
+}
+
+// Returns true if a mesh is always drawn as-is: visible, with a single material and without LoD
+// or Alt variants
+bool is_static(const Model& model, const Model::Mesh& mesh)
+{
+    return mesh.visible && mesh.alt == 0 && mesh.materials.size() == 1 &&
+           std::count_if(model.meshes.begin(), model.meshes.end(),
+                         [&](const auto& other) { return other.name == mesh.name; }) == 1;
+}
+
+// Merges the static meshes of a model that share a material and its parameters into @a merged.
+// Returns the meshes to create: the other meshes and the merged meshes, in model order.
+std::vector<const Model::Mesh*> merge_meshes(const Model& model, std::vector<Model::Mesh>& merged)
+{
+    // Reserving up front keeps the pointers to the merged meshes valid
+    merged.clear();
+    merged.reserve(model.meshes.size());
+
+    std::vector<const Model::Mesh*> meshes;
+    for (const auto& mesh : model.meshes) {
+        if (!is_static(model, mesh)) {
+            meshes.push_back(&mesh);
+            continue;
+        }
+
+        const auto& material = mesh.materials[0];
+        const auto  target   = std::find_if(merged.begin(), merged.end(), [&](const auto& other) {
+            const auto& other_material = other.materials[0];
+            return other_material.name == material.name &&
+                   equal_params(other_material.params, material.params) &&
+                   other_material.compact_vertices.empty() == material.compact_vertices.empty() &&
+                   vertex_count(other_material) + vertex_count(material) <= MAX_MESH_VERTICES;
+        });
+        if (target == merged.end()) {
+            meshes.push_back(&merged.emplace_back(mesh));
+            continue;
+        }
 
-ModelCreator::ModelCreator(khepri::renderer::Renderer&        renderer,
-                           Loader<khepri::renderer::Material> material_loader,
-                           Loader<khepri::renderer::Texture>  texture_loader)
+        // Vertices are in object space, so they can be combined as-is
+        auto&      target_material = target->materials[0];
+        const auto base            = vertex_count(target_material);
+        target_material.vertices.insert(target_material.vertices.end(), material.vertices.begin(),
+                                        material.vertices.end());
+        target_material.compact_vertices.insert(target_material.compact_vertices.end(),
+                                                material.compact_vertices.begin(),
+                                                material.compact_vertices.end());
+        for (const auto index : material.indices) {
+            target_material.indices.push_back(static_cast<Model::Index>(base + index));
+        }
+        target->bounding_box.merge(mesh.bounding_box);
+    }
+    return meshes;
+}
+
+// Seeds and multipliers of the hashes of mesh contents
+constexpr std::uint64_t HASH_SEED        = 0x243f6a8885a308d3ull;
+constexpr std::uint64_t HASH_MULTIPLIER  = 0x9e3779b97f4a7c15ull;
+constexpr std::uint64_t CHECK_SEED       = 0x13198a2e03707344ull;
+constexpr std::uint64_t CHECK_MULTIPLIER = 0xc2b2ae3d27d4eb4full;
+
+constexpr std::uint64_t rotate_left(std::uint64_t value, int shift) noexcept
+{
+    return (value << shift) | (value >> (64 - shift));
+}
+
+// Final mixing step of a hash, so that every input bit affects every output bit
+constexpr std::uint64_t finalize_hash(std::uint64_t h) noexcept
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+// The hashes of a mesh's contents. The key finds the meshes that may have the same contents. The
+// check hash is computed differently, with the size of every block mixed in before its data, so
+// contents whose keys collide are told apart without keeping a copy of them.
+struct ContentHash
+{
+    std::uint64_t key{HASH_SEED};
+    std::uint64_t check{CHECK_SEED};
+
+    // Adds a block of memory to the hashes, 8 bytes at a time
+    void add(const void* data, std::size_t size) noexcept
+    {
+        const auto* bytes     = static_cast<const std::uint8_t*>(data);
+        const auto  mix_check = [&](std::uint64_t word) {
+            check = rotate_left(check + word * CHECK_MULTIPLIER, 31) * HASH_MULTIPLIER;
+        };
+
+        mix_check(size);
+        std::size_t i = 0;
+        for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t)) {
+            std::uint64_t word;
+            std::memcpy(&word, bytes + i, sizeof(word));
+            key = rotate_left(key ^ word, 31) * HASH_MULTIPLIER;
+            mix_check(word);
+        }
+        std::uint64_t tail = 0;
+        if (i < size) {
+            std::memcpy(&tail, bytes + i, size - i);
+            mix_check(tail);
+        }
+        key = rotate_left(key ^ tail ^ size, 31) * HASH_MULTIPLIER;
+    }
+};
+
+// A mesh whose vertices and material parameters are converted for the renderer, but whose
+// resources are not created yet
+struct ConvertedMesh
+{
+    khepri::renderer::MeshDesc            mesh_desc;
+    std::vector<RenderModel::Mesh::Param> params;
+    std::vector<std::uint32_t>            param_slots;
+
+    // For every parameter, the name of its texture if it is a texture parameter. The textures
+    // are loaded when the mesh is created.
+    std::vector<const std::string*> textures;
+};
+
+// Converts a mesh's material. This does not create resources, so it may run on any thread.
+ConvertedMesh convert_mesh(const Model::Material& material, const MaterialInfo* material_info,
+                           bool with_mesh_desc)
+{
+    ConvertedMesh converted;
+    if (with_mesh_desc) {
+        converted.mesh_desc = ModelCreator::create_mesh_desc(material);
+    }
+
+    // Set up material parameters. If the material is known, every parameter is bound to the
+    // slot of its shader property here, once. Parameters that the material does not list may
+    // still be used by the shader, so they are kept without a slot.
+    for (const auto& param : material.params) {
+        auto slot = static_cast<std::uint32_t>(converted.params.size());
+        if (material_info != nullptr) {
+            slot = material_info->slot(param.name).value_or(MaterialInfo::NO_SLOT);
+        }
+
+        // khepri identifies material parameters by string
+        std::string        name(param.name.str());
+        const std::string* texture = nullptr;
+        if (auto val = std::get_if<std::int32_t>(&param.value)) {
+            converted.params.push_back({std::move(name), *val});
+        } else if (auto val = std::get_if<float>(&param.value)) {
+            converted.params.push_back({std::move(name), *val});
+        } else if (auto val = std::get_if<khepri::Vector3f>(&param.value)) {
+            converted.params.push_back({std::move(name), *val});
+        } else if (auto val = std::get_if<khepri::Vector4f>(&param.value)) {
+            converted.params.push_back({std::move(name), *val});
+        } else if (auto val = std::get_if<std::string>(&param.value)) {
+            converted.params.push_back(
+                {std::move(name), static_cast<khepri::renderer::Texture*>(nullptr)});
+            texture = val;
+        }
+        converted.param_slots.push_back(slot);
+        converted.textures.push_back(texture);
+    }
+    return converted;
+}
+
+} // namespace
+
+ModelCreator::ModelCreator(khepri::renderer::Renderer&       renderer,
+                           MaterialLoader                    material_loader,
+                           Loader<khepri::renderer::Texture> texture_loader,
+                           MaterialInfoLoader                material_info_loader)
     : m_renderer(renderer)
     , m_material_loader(std::move(material_loader))
     , m_texture_loader(std::move(texture_loader))
+    , m_material_info_loader(std::move(material_info_loader))
 {}
 
+Symbol ModelCreator::material_name(Symbol mesh_material)
+{
+    auto [it, inserted] = m_material_names.try_emplace(mesh_material);
+    if (inserted) {
+        it->second = Symbol(khepri::basename(mesh_material.str()));
+    }
+    return it->second;
+}
+
 std::unique_ptr<RenderModel> ModelCreator::create_model(const Model& model)
 {
-    std::vector<RenderModel::Mesh> render_meshes;
-    for (const auto& mesh : model.meshes) {
-        const auto& material = mesh.materials[0];
-        if (auto* render_material = m_material_loader(khepri::basename(material.name))) {
-            // Create the renderable mesh
-            khepri::renderer::MeshDesc mesh_desc;
-            mesh_desc.vertices.reserve(material.vertices.size());
-            for (const auto& v : material.vertices) {
-                mesh_desc.vertices.push_back(
-                    {v.position, v.normal, v.tangent, v.binormal, v.uv[0], v.color});
-            }
-            mesh_desc.indices = material.indices;
-            auto render_mesh  = m_renderer.create_mesh(mesh_desc);
-
-            // Set up material parameters
-            std::vector<RenderModel::Mesh::Param> params;
-            for (const auto& param : material.params) {
-                if (auto val = std::get_if<std::int32_t>(&param.value)) {
-                    params.push_back({param.name, *val});
-                } else if (auto val = std::get_if<float>(&param.value)) {
-                    params.push_back({param.name, *val});
-                } else if (auto val = std::get_if<khepri::Vector3f>(&param.value)) {
-                    params.push_back({param.name, *val});
-                } else if (auto val = std::get_if<khepri::Vector4f>(&param.value)) {
-                    params.push_back({param.name, *val});
-                } else if (auto val = std::get_if<std::string>(&param.value)) {
-                    if (auto* texture = m_texture_loader(khepri::basename(*val))) {
-                        params.push_back({param.name, texture});
-                    }
+    return create_render_model(model, nullptr);
+}
+
+std::unique_ptr<RenderModel> ModelCreator::create_model(const Model&               model,
+                                                        std::vector<DeferredMesh>& deferred)
+{
+    deferred.clear();
+    return create_render_model(model, &deferred);
+}
+
+khepri::renderer::MeshDesc ModelCreator::create_mesh_desc(const Model::Material& material)
+{
+    gsl::span<const Model::Vertex> vertices = material.vertices;
+    std::vector<Model::Vertex>     decompressed;
+    if (!material.compact_vertices.empty()) {
+        decompressed.resize(material.compact_vertices.size());
+        decompress_vertices(material.compact_vertices, decompressed);
+        vertices = decompressed;
+    }
+
+    khepri::renderer::MeshDesc mesh_desc;
+    mesh_desc.vertices.reserve(vertices.size());
+    for (const auto& v : vertices) {
+        mesh_desc.vertices.push_back(
+            {v.position, v.normal, v.tangent, v.binormal, v.uv[0], v.color});
+    }
+    mesh_desc.indices = material.indices;
+    return mesh_desc;
+}
+
+std::shared_ptr<khepri::renderer::Mesh>
+ModelCreator::create_mesh(const khepri::renderer::MeshDesc& desc)
+{
+    std::uint32_t mesh_index = 0;
+    return create_mesh(desc, mesh_index);
+}
+
+void ModelCreator::create_deferred_mesh(RenderModel& model, std::size_t mesh,
+                                        const khepri::renderer::MeshDesc& desc)
+{
+    std::uint32_t mesh_index  = 0;
+    auto          render_mesh = create_mesh(desc, mesh_index);
+    const auto*   info        = model.meshes()[mesh].material_info;
+    const auto    sort_key =
+        SortKey::create(info != nullptr ? info->sort_info : MaterialSortInfo{}, mesh_index);
+    model.render_mesh(mesh, std::move(render_mesh), sort_key);
+}
+
+std::shared_ptr<khepri::renderer::Mesh>
+ModelCreator::create_mesh(const khepri::renderer::MeshDesc& desc, std::uint32_t& mesh_index)
+{
+    if (!m_deduplicate_meshes) {
+        mesh_index = m_next_mesh_index++;
+        return m_renderer.create_mesh(desc);
+    }
+
+    // Vertices are hashed as raw bytes, so they must not contain padding
+    using Vertex = khepri::renderer::MeshDesc::Vertex;
+    static_assert(sizeof(Vertex) == sizeof(float) * 18);
+
+    const auto vertex_bytes = desc.vertices.size() * sizeof(Vertex);
+    const auto index_bytes  = desc.indices.size() * sizeof(khepri::renderer::MeshDesc::Index);
+
+    ContentHash hash;
+    hash.add(desc.vertices.data(), vertex_bytes);
+    hash.add(desc.indices.data(), index_bytes);
+    const auto key   = finalize_hash(hash.key);
+    const auto check = finalize_hash(hash.check);
+
+    const auto [first, last] = m_meshes.equal_range(key);
+    auto entry = std::find_if(first, last, [&](const auto& e) { return e.second.check == check; });
+    if (entry != last) {
+        if (auto mesh = entry->second.mesh.lock()) {
+            ++m_deduplicated_meshes;
+            m_deduplicated_bytes += vertex_bytes + index_bytes;
+            mesh_index = entry->second.index;
+            return mesh;
+        }
+    } else {
+        if (m_meshes.size() >= m_meshes_prune_size) {
+            prune_meshes();
+        }
+        entry = m_meshes.emplace(key, SharedMesh{check, m_next_mesh_index++, {}});
+    }
+
+    std::shared_ptr<khepri::renderer::Mesh> mesh = m_renderer.create_mesh(desc);
+    entry->second.mesh                           = mesh;
+    mesh_index                                   = entry->second.index;
+    return mesh;
+}
+
+void ModelCreator::prune_meshes()
+{
+    for (auto it = m_meshes.begin(); it != m_meshes.end();) {
+        it = it->second.mesh.expired() ? m_meshes.erase(it) : std::next(it);
+    }
+    m_meshes_prune_size = std::max(m_meshes.size() * 2, MIN_MESHES_PRUNE_SIZE);
+}
+
+std::unique_ptr<RenderModel>
+ModelCreator::create_render_model(const Model& model, std::vector<DeferredMesh>* deferred)
+{
+    std::vector<Model::Mesh>        merged_meshes;
+    std::vector<const Model::Mesh*> meshes;
+    if (m_merge_static_meshes) {
+        meshes = merge_meshes(model, merged_meshes);
+    } else {
+        for (const auto& mesh : model.meshes) {
+            meshes.push_back(&mesh);
+        }
+    }
+
+    // Meshes without material are not created, so they don't count as LoD variants either
+    std::vector<khepri::renderer::Material*> render_materials;
+    std::vector<const MaterialInfo*>         material_infos;
+    std::vector<std::size_t>                 created;
+    render_materials.reserve(meshes.size());
+    material_infos.reserve(meshes.size());
+    for (std::size_t i = 0; i < meshes.size(); ++i) {
+        const auto material_name = this->material_name(meshes[i]->materials[0].name);
+        auto*      material      = m_material_loader(material_name);
+        render_materials.push_back(material);
+        material_infos.push_back(material != nullptr && m_material_info_loader
+                                     ? m_material_info_loader(material_name)
+                                     : nullptr);
+        if (material != nullptr) {
+            created.push_back(i);
+        }
+    }
+
+    // A mesh's renderable mesh is created later if it has a less detailed variant that is
+    // created now
+    const auto has_less_detail = [&](std::size_t i) {
+        return std::any_of(created.begin(), created.end(), [&](std::size_t j) {
+            return meshes[j]->name == meshes[i]->name && meshes[j]->alt == meshes[i]->alt &&
+                   meshes[j]->lod < meshes[i]->lod;
+        });
+    };
+    std::vector<bool> is_deferred(meshes.size(), false);
+    const auto        first_deferred = deferred != nullptr ? deferred->size() : 0;
+    if (deferred != nullptr) {
+        for (const auto i : created) {
+            is_deferred[i] = has_less_detail(i);
+        }
+    }
+
+    std::vector<ConvertedMesh> converted(created.size());
+
+    const auto convert = [&](std::size_t n) {
+        const auto i = created[n];
+        converted[n] = convert_mesh(meshes[i]->materials[0], material_infos[i], !is_deferred[i]);
+    };
+
+    std::vector<RenderModel::Mesh>  render_meshes;
+    std::vector<const Model::Mesh*> sources;
+
+    // Creates the resources of a converted mesh. This calls the loaders and the renderer, so it
+    // runs on the calling thread, in model order.
+    const auto create = [&](std::size_t n) {
+        const auto  i             = created[n];
+        const auto& mesh          = *meshes[i];
+        const auto* material_info = material_infos[i];
+        auto&       params        = converted[n].params;
+        auto&       param_slots   = converted[n].param_slots;
+
+        // Load the textures of texture parameters; parameters without texture are dropped
+        std::size_t num_params = 0;
+        for (std::size_t p = 0; p < params.size(); ++p) {
+            if (const auto* texture_name = converted[n].textures[p]) {
+                auto* texture = m_texture_loader(khepri::basename(*texture_name));
+                if (texture == nullptr) {
+                    continue;
                 }
+                params[p].value = texture;
+            }
+            if (num_params != p) {
+                params[num_params]      = std::move(params[p]);
+                param_slots[num_params] = param_slots[p];
             }
+            ++num_params;
+        }
+        params.erase(params.begin() + num_params, params.end());
+        param_slots.erase(param_slots.begin() + num_params, param_slots.end());
+        if (material_info != nullptr) {
+            sort_by_slot(params, param_slots);
+        } else {
+            param_slots.clear();
+        }
 
-            render_meshes.push_back({mesh.name, std::move(render_mesh), render_material,
-                                     std::move(params), mesh.visible});
+        // Create the renderable mesh, unless it is created later. Meshes that share a renderable
+        // mesh share its index in their sort keys, so their instances are drawn together.
+        std::shared_ptr<khepri::renderer::Mesh> render_mesh;
+        std::uint32_t                           mesh_index = 0;
+        if (is_deferred[i]) {
+            deferred->push_back({render_meshes.size(),
+                                 static_cast<std::size_t>(meshes[i] - model.meshes.data()),
+                                 mesh.lod, false});
+        } else {
+            render_mesh = create_mesh(converted[n].mesh_desc, mesh_index);
         }
+
+        const auto sort_key = SortKey::create(
+            material_info != nullptr ? material_info->sort_info : MaterialSortInfo{}, mesh_index);
+
+        render_meshes.push_back({mesh.name, mesh.lod, mesh.alt, std::move(render_mesh),
+                                 render_materials[i], material_info, std::move(params),
+                                 std::move(param_slots), mesh.visible, mesh.bounding_box,
+                                 sort_key});
+        sources.push_back(meshes[i]);
+        converted[n] = {};
+    };
+
+    if (m_thread_pool != nullptr) {
+        // Convert all meshes in parallel, then create their resources in order on this thread
+        m_thread_pool->parallel_for(created.size(), convert);
+        for (std::size_t n = 0; n < created.size(); ++n) {
+            create(n);
+        }
+    } else {
+        for (std::size_t n = 0; n < created.size(); ++n) {
+            convert(n);
+            create(n);
+        }
+    }
+
+    // The deferred meshes' geometry is added to the occluder once it is loaded, unless the
+    // occluder is too large already
+    auto occluder = create_occluder(render_meshes, sources);
+    if (deferred != nullptr) {
+        for (auto it = deferred->begin() + first_deferred; it != deferred->end(); ++it) {
+            it->occluder = occluder.has_value() && is_occluder(render_meshes, it->mesh);
+        }
+    }
+    return std::make_unique<RenderModel>(std::move(render_meshes),
+                                         std::move(occluder).value_or(RenderModel::Occluder{}));
+}
+
+bool ModelCreator::add_to_occluder(RenderModel::Occluder& occluder, const Model::Material& material)
+{
+    if (occluder.indices.size() + material.indices.size() > MAX_OCCLUDER_TRIANGLES * 3) {
+        return false;
+    }
+    const auto base = static_cast<std::uint32_t>(occluder.vertices.size());
+    for (const auto& vertex : material.vertices) {
+        occluder.vertices.push_back(vertex.position);
+    }
+    for (const auto& vertex : material.compact_vertices) {
+        occluder.vertices.push_back(vertex.position);
+    }
+    for (const auto index : material.indices) {
+        occluder.indices.push_back(base + index);
     }
-    return std::make_unique<RenderModel>(std::move(render_meshes));
+    return true;
 }
 
 } // namespace openglyph::renderer
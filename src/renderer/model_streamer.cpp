@@ -0,0 +1,221 @@
+#include <khepri/io/exceptions.hpp>
+#include <khepri/log/log.hpp>
+#include <openglyph/renderer/model_streamer.hpp>
+
+#include <algorithm>
+#include <chrono>
+
+namespace openglyph::renderer {
+namespace {
+constexpr khepri::log::Logger LOG("renderer");
+
+// Reads the entire contents of a stream
+std::vector<std::uint8_t> read_all(khepri::io::Stream& stream)
+{
+    const auto size = stream.seek(0, khepri::io::SeekOrigin::end);
+    stream.seek(0, khepri::io::SeekOrigin::begin);
+
+    std::vector<std::uint8_t> data(static_cast<std::size_t>(size));
+    if (stream.read(data.data(), data.size()) != data.size()) {
+        throw khepri::io::Error("unable to read model");
+    }
+    return data;
+}
+
+// Returns true if a mesh of a model has a less detailed variant
+bool has_less_detail(const openglyph::io::ModelView& view, std::size_t mesh)
+{
+    const auto& info = view.mesh(mesh);
+    for (std::size_t i = 0; i < view.mesh_count(); ++i) {
+        const auto& other = view.mesh(i);
+        if (other.name == info.name && other.alt == info.alt && other.lod < info.lod) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+ModelStreamer::ModelStreamer(ModelCreator& model_creator, StreamLoader loader,
+                             const Options& options)
+    : m_model_creator(model_creator), m_loader(std::move(loader)), m_options(options)
+{}
+
+ModelStreamer::~ModelStreamer()
+{
+    // Pending loads use the entries' data
+    for (auto& load : m_pending) {
+        load.result.wait();
+    }
+}
+
+std::unique_ptr<RenderModel> ModelStreamer::load(std::string_view name)
+{
+    auto stream = m_loader(name);
+    if (!stream) {
+        return {};
+    }
+
+    auto entry  = std::make_unique<Entry>();
+    entry->name = std::string(name);
+    entry->data = read_all(*stream);
+    entry->view = std::make_unique<openglyph::io::ModelView>(entry->data);
+
+    // Only the least detailed variants are decoded now; the others need just their parameters
+    auto& view = *entry->view;
+    Model model;
+    model.meshes.reserve(view.mesh_count());
+    for (std::size_t i = 0; i < view.mesh_count(); ++i) {
+        const auto& info = view.mesh(i);
+        auto&       mesh = model.meshes.emplace_back();
+
+        mesh.name         = info.name;
+        mesh.lod          = info.lod;
+        mesh.alt          = info.alt;
+        mesh.visible      = info.visible;
+        mesh.bounding_box = info.bounding_box;
+
+        const bool deferred = has_less_detail(view, i);
+        for (std::size_t j = 0; j < info.material_count; ++j) {
+            mesh.materials.push_back(deferred ? view.shader(i, j) : view.material(i, j));
+        }
+    }
+
+    auto render_model = m_model_creator.create_model(model, entry->meshes);
+    if (!entry->meshes.empty()) {
+        std::stable_sort(entry->meshes.begin(), entry->meshes.end(),
+                         [](const auto& m1, const auto& m2) { return m1.lod < m2.lod; });
+        for (const auto& mesh : entry->meshes) {
+            if (mesh.occluder) {
+                entry->occluder_sources.push_back(mesh.source);
+            }
+        }
+        entry->model = render_model.get();
+        m_entries.push_back(std::move(entry));
+    }
+    return render_model;
+}
+
+void ModelStreamer::update()
+{
+    complete_loads();
+    start_loads();
+}
+
+void ModelStreamer::cancel(const RenderModel& model) noexcept
+{
+    for (auto& entry : m_entries) {
+        if (entry->model == &model) {
+            // A pending load still uses the entry; it is destroyed once that load completes
+            entry->model = nullptr;
+            entry->meshes.clear();
+        }
+    }
+    remove_done_entries();
+}
+
+void ModelStreamer::complete_loads()
+{
+    using namespace std::chrono_literals;
+
+    auto it = std::remove_if(m_pending.begin(), m_pending.end(), [&](PendingLoad& load) {
+        if (load.result.wait_for(0s) != std::future_status::ready) {
+            return false;
+        }
+
+        auto& entry   = *load.entry;
+        entry.pending = false;
+        if (entry.model == nullptr) {
+            // Canceled
+            return true;
+        }
+        try {
+            for (const auto& [mesh, mesh_desc] : load.result.get()) {
+                m_model_creator.create_deferred_mesh(*entry.model, mesh, mesh_desc);
+            }
+            if (entry.meshes.empty()) {
+                complete_occluder(entry);
+            }
+        } catch (const std::exception& e) {
+            // Higher levels can't become resident without this one
+            LOG.error("unable to stream model \"{}\": {}", entry.name, e.what());
+            entry.meshes.clear();
+        }
+        ++m_generation;
+        return true;
+    });
+    m_pending.erase(it, m_pending.end());
+
+    remove_done_entries();
+}
+
+void ModelStreamer::complete_occluder(Entry& entry)
+{
+    if (entry.occluder_sources.empty()) {
+        return;
+    }
+
+    // The view keeps the materials that were decoded for the meshes
+    auto occluder = entry.model->occluder();
+    for (const auto source : entry.occluder_sources) {
+        if (!ModelCreator::add_to_occluder(occluder, entry.view->material(source, 0))) {
+            // Too large to rasterize, like models that are too large when they are created
+            occluder = {};
+            break;
+        }
+    }
+    entry.model->occluder(std::move(occluder));
+}
+
+void ModelStreamer::remove_done_entries() noexcept
+{
+    // Models without meshes to stream no longer need their data
+    const auto done = [](const auto& entry) { return !entry->pending && entry->meshes.empty(); };
+    m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(), done), m_entries.end());
+}
+
+void ModelStreamer::start_loads()
+{
+    for (auto& entry : m_entries) {
+        if (m_pending.size() >= m_options.max_pending_loads) {
+            break;
+        }
+        if (!entry->pending && !entry->meshes.empty()) {
+            start_load(*entry);
+        }
+    }
+}
+
+void ModelStreamer::start_load(Entry& entry)
+{
+    // Take the meshes of the next LoD level
+    const auto lod  = entry.meshes.front().lod;
+    const auto last = std::find_if(entry.meshes.begin(), entry.meshes.end(),
+                                   [&](const auto& mesh) { return mesh.lod != lod; });
+    std::vector<ModelCreator::DeferredMesh> meshes(entry.meshes.begin(), last);
+    entry.meshes.erase(entry.meshes.begin(), last);
+
+    // The view is only used by this load until it completes
+    auto decode = [&view = *entry.view, meshes = std::move(meshes)] {
+        MeshDescs mesh_descs;
+        mesh_descs.reserve(meshes.size());
+        for (const auto& mesh : meshes) {
+            const auto& material = view.material(mesh.source, 0);
+            mesh_descs.emplace_back(mesh.mesh, ModelCreator::create_mesh_desc(material));
+        }
+        return mesh_descs;
+    };
+    std::future<MeshDescs> result;
+    if (auto* thread_pool = m_model_creator.thread_pool()) {
+        result = thread_pool->async(std::move(decode));
+    } else {
+        std::packaged_task<MeshDescs()> task(std::move(decode));
+        result = task.get_future();
+        task();
+    }
+    entry.pending = true;
+    m_pending.push_back({&entry, std::move(result)});
+}
+
+} // namespace openglyph::renderer
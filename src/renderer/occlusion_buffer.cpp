@@ -0,0 +1,240 @@
+#include <openglyph/renderer/occlusion_buffer.hpp>
+#include <openglyph/utility/matrix_layout.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define OPENGLYPH_OCCLUSION_BUFFER_SSE
+#endif
+
+namespace openglyph::renderer {
+namespace {
+
+constexpr float INFINITE_DEPTH = std::numeric_limits<float>::infinity();
+
+// Vertices closer than this to the camera plane are considered to cross the near plane
+constexpr float MIN_DEPTH = 1e-3f;
+
+// Clamps a coordinate in pixels to a pixel index in [0, size)
+int to_pixel(float coordinate, unsigned int size) noexcept
+{
+    return static_cast<int>(std::clamp(std::floor(coordinate), 0.0f, static_cast<float>(size - 1)));
+}
+
+} // namespace
+
+OcclusionBuffer::OcclusionBuffer(unsigned int width, unsigned int height)
+    : m_width((width + 3) & ~3u), m_height(height)
+{
+    if (width == 0 || height == 0) {
+        throw std::invalid_argument("occlusion buffer size must not be zero");
+    }
+    m_depths.assign(std::size_t{m_width} * m_height, INFINITE_DEPTH);
+}
+
+void OcclusionBuffer::clear(const khepri::Matrixf& view_proj)
+{
+    m_view_proj = transform_coefficients(view_proj);
+
+    std::fill(m_depths.begin(), m_depths.end(), INFINITE_DEPTH);
+}
+
+void OcclusionBuffer::add_occluder(gsl::span<const khepri::Vector3f> vertices,
+                                   gsl::span<const std::uint32_t>    indices,
+                                   const khepri::Matrixf&            transform)
+{
+    const auto rows = to_clip(transform);
+    m_screen_vertices.resize(vertices.size());
+    for (std::size_t i = 0; i < vertices.size(); ++i) {
+        m_screen_vertices[i] = to_screen(rows, vertices[i]);
+    }
+
+    for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+        if (indices[i] >= vertices.size() || indices[i + 1] >= vertices.size() ||
+            indices[i + 2] >= vertices.size()) {
+            continue;
+        }
+        const auto& v0 = m_screen_vertices[indices[i]];
+        const auto& v1 = m_screen_vertices[indices[i + 1]];
+        const auto& v2 = m_screen_vertices[indices[i + 2]];
+        // Triangles that cross the near plane are skipped; that only makes culling less effective
+        if (v0.depth > 0 && v1.depth > 0 && v2.depth > 0) {
+            rasterize(v0, v1, v2);
+        }
+    }
+}
+
+bool OcclusionBuffer::is_visible(const BoundingBox& box, const khepri::Matrixf& transform) const
+{
+    const auto rows = to_clip(transform);
+
+    float min_x     = INFINITE_DEPTH;
+    float min_y     = INFINITE_DEPTH;
+    float max_x     = -INFINITE_DEPTH;
+    float max_y     = -INFINITE_DEPTH;
+    float min_depth = INFINITE_DEPTH;
+    for (unsigned int i = 0; i < 8; ++i) {
+        const khepri::Vector3f corner{(i & 1) != 0 ? box.max.x : box.min.x,
+                                      (i & 2) != 0 ? box.max.y : box.min.y,
+                                      (i & 4) != 0 ? box.max.z : box.min.z};
+        const auto v = to_screen(rows, corner);
+        if (v.depth <= 0) {
+            // The box crosses the near plane
+            return true;
+        }
+        min_x     = std::min(min_x, v.x);
+        min_y     = std::min(min_y, v.y);
+        max_x     = std::max(max_x, v.x);
+        max_y     = std::max(max_y, v.y);
+        min_depth = std::min(min_depth, v.depth);
+    }
+
+    if (max_x < 0 || max_y < 0 || min_x >= m_width || min_y >= m_height) {
+        // Off screen; that's for frustum culling to decide
+        return true;
+    }
+
+    // The box is visible if any pixel it covers has no occluder in front of the box
+    const int x0 = to_pixel(min_x, m_width);
+    const int x1 = to_pixel(max_x, m_width);
+    const int y0 = to_pixel(min_y, m_height);
+    const int y1 = to_pixel(max_y, m_height);
+    for (int y = y0; y <= y1; ++y) {
+        const float* row = &m_depths[std::size_t{m_width} * y];
+        int          x   = x0;
+#ifdef OPENGLYPH_OCCLUSION_BUFFER_SSE
+        const __m128 depth   = _mm_set1_ps(min_depth);
+        const __m128 offsets = _mm_setr_ps(0, 1, 2, 3);
+        const __m128 first   = _mm_set1_ps(static_cast<float>(x0));
+        const __m128 last    = _mm_set1_ps(static_cast<float>(x1));
+        for (x = x0 & ~3; x <= x1; x += 4) {
+            const __m128 xs       = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offsets);
+            const __m128 in_range = _mm_and_ps(_mm_cmpge_ps(xs, first), _mm_cmple_ps(xs, last));
+            const __m128 visible  = _mm_cmpge_ps(_mm_loadu_ps(row + x), depth);
+            if (_mm_movemask_ps(_mm_and_ps(in_range, visible)) != 0) {
+                return true;
+            }
+        }
+#endif
+        for (; x <= x1; ++x) {
+            if (row[x] >= min_depth) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+OcclusionBuffer::Rows OcclusionBuffer::to_clip(const khepri::Matrixf& transform) const noexcept
+{
+    // Combine the object's transform with the camera's
+    const auto world = transform_coefficients(transform);
+    Rows       rows{};
+    for (std::size_t j = 0; j < 4; ++j) {
+        for (std::size_t k = 0; k < 4; ++k) {
+            rows[j][k] = m_view_proj[j][0] * world[0][k] + m_view_proj[j][1] * world[1][k] +
+                         m_view_proj[j][2] * world[2][k] + m_view_proj[j][3] * world[3][k];
+        }
+    }
+    return rows;
+}
+
+OcclusionBuffer::ScreenVertex OcclusionBuffer::to_screen(const Rows&             rows,
+                                                         const khepri::Vector3f& v) const noexcept
+{
+    const auto clip = [&](std::size_t i) {
+        return rows[i][0] * v.x + rows[i][1] * v.y + rows[i][2] * v.z + rows[i][3];
+    };
+
+    // The clip-space W coordinate is the view-space depth
+    const float w = clip(3);
+    if (w < MIN_DEPTH) {
+        return {0, 0, 0};
+    }
+    return {(clip(0) / w * 0.5f + 0.5f) * m_width, (0.5f - clip(1) / w * 0.5f) * m_height, w};
+}
+
+void OcclusionBuffer::rasterize(ScreenVertex v0, ScreenVertex v1, ScreenVertex v2) noexcept
+{
+    const float area = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+    if (area == 0) {
+        return;
+    }
+    if (area < 0) {
+        // Accept both windings; all edge functions are positive inside the triangle below
+        std::swap(v1, v2);
+    }
+
+    const float min_x = std::min({v0.x, v1.x, v2.x});
+    const float max_x = std::max({v0.x, v1.x, v2.x});
+    const float min_y = std::min({v0.y, v1.y, v2.y});
+    const float max_y = std::max({v0.y, v1.y, v2.y});
+    if (max_x < 0 || max_y < 0 || min_x >= m_width || min_y >= m_height) {
+        return;
+    }
+
+    // The farthest vertex's depth for the whole triangle keeps the buffer conservative
+    const float depth = std::max({v0.depth, v1.depth, v2.depth});
+
+    // Edge functions e(x, y) = a * x + b * y + c, evaluated at pixel centers
+    const ScreenVertex* vertices[] = {&v0, &v1, &v2};
+    float               a[3];
+    float               b[3];
+    float               c[3];
+    for (std::size_t i = 0; i < 3; ++i) {
+        const auto& from = *vertices[i];
+        const auto& to   = *vertices[(i + 1) % 3];
+        a[i]             = from.y - to.y;
+        b[i]             = to.x - from.x;
+        c[i]             = -(a[i] * from.x + b[i] * from.y);
+    }
+
+    const int x0 = to_pixel(min_x, m_width);
+    const int x1 = to_pixel(max_x, m_width);
+    const int y0 = to_pixel(min_y, m_height);
+    const int y1 = to_pixel(max_y, m_height);
+    for (int y = y0; y <= y1; ++y) {
+        const float py  = static_cast<float>(y) + 0.5f;
+        float*      row = &m_depths[std::size_t{m_width} * y];
+        int         x   = x0;
+#ifdef OPENGLYPH_OCCLUSION_BUFFER_SSE
+        // The buffer's width is a multiple of 4, so aligned groups of 4 pixels stay in the row
+        const __m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+        const __m128 zero    = _mm_setzero_ps();
+        const __m128 depths  = _mm_set1_ps(depth);
+        __m128       edge_a[3];
+        __m128       edge_row[3];
+        for (std::size_t i = 0; i < 3; ++i) {
+            edge_a[i]   = _mm_set1_ps(a[i]);
+            edge_row[i] = _mm_set1_ps(b[i] * py + c[i]);
+        }
+        for (x = x0 & ~3; x <= x1; x += 4) {
+            const __m128 px     = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), offsets);
+            const auto   inside = [&](std::size_t i) {
+                return _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(edge_a[i], px), edge_row[i]), zero);
+            };
+            const __m128 mask = _mm_and_ps(_mm_and_ps(inside(0), inside(1)), inside(2));
+            if (_mm_movemask_ps(mask) == 0) {
+                continue;
+            }
+            const __m128 old_depths = _mm_loadu_ps(row + x);
+            const __m128 new_depths = _mm_min_ps(old_depths, depths);
+            _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(mask, new_depths),
+                                             _mm_andnot_ps(mask, old_depths)));
+        }
+#endif
+        for (; x <= x1; ++x) {
+            const float px = static_cast<float>(x) + 0.5f;
+            if (a[0] * px + b[0] * py + c[0] >= 0 && a[1] * px + b[1] * py + c[1] >= 0 &&
+                a[2] * px + b[2] * py + c[2] >= 0) {
+                row[x] = std::min(row[x], depth);
+            }
+        }
+    }
+}
+
+} // namespace openglyph::renderer
@@ -0,0 +1,58 @@
+#include <openglyph/renderer/render_model.hpp>
+
+#include <algorithm>
+
+namespace openglyph::renderer {
+
+RenderModel::RenderModel(std::vector<Mesh> meshes, Occluder occluder)
+    : m_meshes(std::move(meshes)), m_occluder(std::move(occluder))
+{
+    if (!m_meshes.empty()) {
+        m_bounding_box = m_meshes.front().bounding_box;
+        for (const auto& mesh : m_meshes) {
+            m_bounding_box.merge(mesh.bounding_box);
+        }
+    }
+
+    // Group the LoD variants of every mesh
+    for (std::size_t i = 0; i < m_meshes.size(); ++i) {
+        const auto& mesh = m_meshes[i];
+        const auto  it   = std::find_if(m_lod_groups.begin(), m_lod_groups.end(), [&](auto& group) {
+            const auto& other = m_meshes[group.meshes.front()];
+            return other.name == mesh.name && other.alt == mesh.alt;
+        });
+        if (it != m_lod_groups.end()) {
+            it->meshes.push_back(i);
+        } else {
+            m_lod_groups.push_back({{i}});
+        }
+    }
+    for (auto& group : m_lod_groups) {
+        std::stable_sort(group.meshes.begin(), group.meshes.end(), [&](auto i1, auto i2) {
+            return m_meshes[i1].lod < m_meshes[i2].lod;
+        });
+        update_residency(group);
+    }
+}
+
+void RenderModel::render_mesh(std::size_t mesh, std::shared_ptr<khepri::renderer::Mesh> render_mesh,
+                              std::uint64_t sort_key)
+{
+    m_meshes[mesh].render_mesh = std::move(render_mesh);
+    m_meshes[mesh].sort_key    = sort_key;
+    for (auto& group : m_lod_groups) {
+        if (std::find(group.meshes.begin(), group.meshes.end(), mesh) != group.meshes.end()) {
+            update_residency(group);
+            break;
+        }
+    }
+}
+
+void RenderModel::update_residency(LodGroup& group) const noexcept
+{
+    const auto it = std::find_if(group.meshes.begin(), group.meshes.end(),
+                                 [&](std::size_t i) { return !m_meshes[i].render_mesh; });
+    group.resident = static_cast<std::size_t>(it - group.meshes.begin());
+}
+
+} // namespace openglyph::renderer
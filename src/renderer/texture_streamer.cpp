@@ -0,0 +1,261 @@
+#include <khepri/io/exceptions.hpp>
+#include <khepri/log/log.hpp>
+#include <khepri/renderer/io/texture.hpp>
+#include <openglyph/renderer/texture_streamer.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace openglyph::renderer {
+namespace {
+constexpr khepri::log::Logger LOG("renderer");
+} // namespace
+
+TextureStreamer::TextureStreamer(khepri::renderer::Renderer& renderer, StreamLoader loader,
+                                 const Options& options)
+    : m_renderer(renderer), m_loader(std::move(loader)), m_options(options)
+{}
+
+TextureStreamer::~TextureStreamer() = default;
+
+std::unique_ptr<khepri::renderer::Texture> TextureStreamer::load(std::string_view name)
+{
+    auto stream = m_loader(name);
+    if (!stream) {
+        return {};
+    }
+
+    auto layout = io::read_dds_layout(*stream);
+    if (!layout || layout->mip_levels <= m_options.proxy_mip_levels) {
+        // Nothing to stream
+        stream->seek(0, khepri::io::SeekOrigin::begin);
+        return m_renderer.create_texture(khepri::renderer::io::load_texture(*stream));
+    }
+
+    Entry entry;
+    entry.id            = m_next_id++;
+    entry.name          = std::string(name);
+    entry.proxy_top_mip = layout->mip_levels - m_options.proxy_mip_levels;
+    for (const auto mip_size : layout->mip_sizes) {
+        entry.mip_sizes.push_back(mip_size * layout->slices);
+    }
+    entry.resident_top_mip = entry.proxy_top_mip;
+    entry.desired_top_mip  = entry.proxy_top_mip;
+
+    auto proxy =
+        m_renderer.create_texture(io::load_dds_mips(*stream, *layout, entry.proxy_top_mip));
+    if (proxy) {
+        entry.layout = std::make_shared<const io::DdsLayout>(std::move(*layout));
+        entry.proxy  = proxy.get();
+        m_entries.emplace(proxy.get(), std::move(entry));
+    }
+    return proxy;
+}
+
+void TextureStreamer::unload(const khepri::renderer::Texture* texture)
+{
+    const auto it = m_entries.find(texture);
+    if (it != m_entries.end()) {
+        // Pending loads for this entry are discarded when they complete
+        release(it->second);
+        m_entries.erase(it);
+        ++m_generation;
+    }
+}
+
+khepri::renderer::Texture*
+TextureStreamer::resolve(khepri::renderer::Texture* texture) const noexcept
+{
+    const auto it = m_entries.find(texture);
+    if (it != m_entries.end() && it->second.resident) {
+        return it->second.resident.get();
+    }
+    return texture;
+}
+
+void TextureStreamer::request(const khepri::renderer::Texture* texture, float screen_size) noexcept
+{
+    const auto it = m_entries.find(texture);
+    if (it != m_entries.end()) {
+        it->second.priority = std::max(it->second.priority, screen_size);
+    }
+}
+
+void TextureStreamer::update()
+{
+    complete_loads();
+
+    for (auto& [key, entry] : m_entries) {
+        entry.desired_top_mip = desired_top_mip(entry);
+    }
+
+    enforce_budget();
+    start_loads();
+
+    // Requests are made anew every frame
+    for (auto& [key, entry] : m_entries) {
+        entry.priority = 0;
+    }
+}
+
+std::size_t TextureStreamer::size_from(const Entry& entry, unsigned int top_mip) const noexcept
+{
+    std::size_t size = 0;
+    for (auto mip = top_mip; mip < entry.mip_sizes.size(); ++mip) {
+        size += entry.mip_sizes[mip];
+    }
+    return size;
+}
+
+unsigned int TextureStreamer::desired_top_mip(const Entry& entry) const noexcept
+{
+    // Pick the smallest mip level that still has at least as many texels as the object covers
+    // pixels on screen.
+    const auto pixels = entry.priority * m_options.screen_height;
+    const auto size   = std::max(entry.layout->width, entry.layout->height);
+
+    unsigned int top_mip = 0;
+    while (top_mip < entry.proxy_top_mip && static_cast<float>(size >> (top_mip + 1)) >= pixels) {
+        ++top_mip;
+    }
+    return top_mip;
+}
+
+void TextureStreamer::complete_loads()
+{
+    using namespace std::chrono_literals;
+
+    auto it = std::remove_if(m_pending.begin(), m_pending.end(), [&](PendingLoad& load) {
+        if (load.result.wait_for(0s) != std::future_status::ready) {
+            return false;
+        }
+
+        m_pending_shrink -= load.shrink;
+        m_pending_growth -= load.growth;
+
+        const auto entry_it = m_entries.find(load.key);
+        if (entry_it == m_entries.end() || entry_it->second.id != load.id) {
+            // The texture was unloaded while its mip levels were loading
+            return true;
+        }
+
+        auto& entry   = entry_it->second;
+        entry.pending = false;
+        try {
+            auto texture = m_renderer.create_texture(load.result.get());
+            if (!texture) {
+                throw khepri::io::Error("unable to create texture");
+            }
+            release(entry);
+            entry.resident         = std::move(texture);
+            entry.resident_top_mip = load.top_mip;
+            m_resident_size += size_from(entry, entry.resident_top_mip);
+            ++m_generation;
+        } catch (const std::exception& e) {
+            // Don't retry the same broken file every frame
+            LOG.error("unable to stream texture \"{}\": {}", entry.name, e.what());
+            entry.failed = true;
+        }
+        return true;
+    });
+    m_pending.erase(it, m_pending.end());
+}
+
+void TextureStreamer::enforce_budget()
+{
+    // Memory that in-flight reloads with fewer mip levels will free is still resident, but it's
+    // counted as freed here so the same memory isn't shed twice.
+    auto projected_size = m_resident_size - std::min(m_resident_size, m_pending_shrink);
+    if (projected_size <= m_options.resident_budget) {
+        return;
+    }
+
+    std::vector<Entry*> entries;
+    for (auto& [key, entry] : m_entries) {
+        if (entry.resident && !entry.pending) {
+            entries.push_back(&entry);
+        }
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry* e1, const Entry* e2) { return e1->priority < e2->priority; });
+
+    // Drop the top mips of the least important textures first. Textures that aren't used at all
+    // fall back to their proxy; other textures are reloaded one mip level lower.
+    for (auto* entry : entries) {
+        if (projected_size <= m_options.resident_budget) {
+            break;
+        }
+        const auto current = size_from(*entry, entry->resident_top_mip);
+        const auto top_mip = std::max(entry->desired_top_mip, entry->resident_top_mip + 1);
+        if (top_mip >= entry->proxy_top_mip || entry->failed) {
+            release(*entry);
+            projected_size -= std::min(projected_size, current);
+            ++m_generation;
+        } else {
+            // The larger texture stays resident (and accounted for) until the smaller one has
+            // loaded, so a failed reload leaves the accounting intact.
+            const auto shrink = current - size_from(*entry, top_mip);
+            projected_size -= std::min(projected_size, shrink);
+            entry->desired_top_mip = top_mip;
+            start_load(entry->proxy, *entry, top_mip, shrink, 0);
+        }
+    }
+}
+
+void TextureStreamer::start_loads()
+{
+    std::vector<std::pair<const khepri::renderer::Texture*, Entry*>> candidates;
+    for (auto& [key, entry] : m_entries) {
+        if (!entry.pending && !entry.failed && entry.desired_top_mip < entry.resident_top_mip) {
+            candidates.emplace_back(key, &entry);
+        }
+    }
+
+    // Largest on-screen textures first
+    std::sort(candidates.begin(), candidates.end(), [](const auto& c1, const auto& c2) {
+        return c1.second->priority > c2.second->priority;
+    });
+
+    for (auto& [key, entry] : candidates) {
+        if (m_pending.size() >= m_options.max_pending_loads) {
+            break;
+        }
+        const auto current = entry->resident ? size_from(*entry, entry->resident_top_mip) : 0;
+        const auto growth  = size_from(*entry, entry->desired_top_mip) - current;
+        // Loads that are still in flight will grow the resident size as well
+        if (m_resident_size + m_pending_growth + growth > m_options.resident_budget) {
+            continue;
+        }
+        start_load(key, *entry, entry->desired_top_mip, 0, growth);
+    }
+}
+
+void TextureStreamer::start_load(const khepri::renderer::Texture* key, Entry& entry,
+                                 unsigned int top_mip, std::size_t shrink, std::size_t growth)
+{
+    entry.pending = true;
+    m_pending_shrink += shrink;
+    m_pending_growth += growth;
+    m_pending.push_back({key, entry.id, top_mip, shrink, growth,
+                         std::async(std::launch::async,
+                                    [loader = m_loader, name = entry.name, layout = entry.layout,
+                                     top_mip]() -> khepri::renderer::TextureDesc {
+                                        auto stream = loader(name);
+                                        if (!stream) {
+                                            throw khepri::io::Error("unable to open texture");
+                                        }
+                                        return io::load_dds_mips(*stream, *layout, top_mip);
+                                    })});
+}
+
+void TextureStreamer::release(Entry& entry)
+{
+    if (entry.resident) {
+        m_resident_size -= std::min(m_resident_size, size_from(entry, entry.resident_top_mip));
+        entry.resident.reset();
+    }
+    entry.resident_top_mip = entry.proxy_top_mip;
+}
+
+} // namespace openglyph::renderer
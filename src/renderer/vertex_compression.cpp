@@ -0,0 +1,473 @@
+#include <openglyph/renderer/vertex_compression.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OPENGLYPH_VERTEX_COMPRESSION_SSE
+#endif
+
+namespace openglyph::renderer {
+namespace {
+
+constexpr float SNORM16_SCALE = 32767.0f;
+constexpr float UNORM8_SCALE  = 255.0f;
+
+// Floats from which on the half-precision result is infinite, and below which it is denormal
+constexpr std::uint32_t HALF_MAX_EXPONENT = (127 + 16) << 23;
+constexpr std::uint32_t HALF_MIN_NORMAL   = (127 - 14) << 23;
+
+// Float whose addition rounds a denormal half-precision mantissa into the lowest bits
+constexpr std::uint32_t HALF_DENORM_MAGIC = ((127 - 15) + (23 - 10) + 1) << 23;
+
+// Float that rebiases a half-precision exponent that is shifted into a float, when multiplied
+constexpr std::uint32_t HALF_EXPONENT_ADJUST = (254 - 15) << 23;
+
+std::uint32_t to_bits(float value) noexcept
+{
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+float from_bits(std::uint32_t bits) noexcept
+{
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Converts a float to a half-precision float, rounding to nearest even
+std::uint16_t float_to_half(float value) noexcept
+{
+    std::uint32_t       bits = to_bits(value);
+    const std::uint32_t sign = bits & 0x80000000u;
+    bits ^= sign;
+
+    std::uint32_t result;
+    if (bits >= HALF_MAX_EXPONENT) {
+        // Infinity or NaN
+        result = bits > 0x7f800000u ? 0x7e00 : 0x7c00;
+    } else if (bits < HALF_MIN_NORMAL) {
+        // Denormal or zero: adding a magic value lets the FPU round the mantissa
+        result = to_bits(from_bits(bits) + from_bits(HALF_DENORM_MAGIC)) - HALF_DENORM_MAGIC;
+    } else {
+        // Rebias the exponent and round the mantissa, to even on ties
+        const std::uint32_t mantissa_odd = (bits >> 13) & 1;
+        bits += (std::uint32_t{15} << 23) - (std::uint32_t{127} << 23) + 0xfff + mantissa_odd;
+        result = bits >> 13;
+    }
+    return static_cast<std::uint16_t>(result | (sign >> 16));
+}
+
+// Converts a half-precision float to a float
+float half_to_float(std::uint16_t value) noexcept
+{
+    // Shift the exponent and mantissa into place and rebias by scaling, which handles denormals
+    const std::uint32_t exponent_mantissa = value & 0x7fffu;
+    const float         scaled =
+        from_bits(exponent_mantissa << 13) * from_bits(HALF_EXPONENT_ADJUST);
+    std::uint32_t bits = to_bits(scaled);
+    if (exponent_mantissa > 0x7bffu) {
+        // Infinity or NaN
+        bits |= 255u << 23;
+    }
+    return from_bits(bits | ((value & 0x8000u) << 16));
+}
+
+std::int16_t to_snorm16(float value) noexcept
+{
+    return static_cast<std::int16_t>(
+        std::nearbyint(std::clamp(value, -1.0f, 1.0f) * SNORM16_SCALE));
+}
+
+float from_snorm16(int value) noexcept
+{
+    return std::max(static_cast<float>(value) * (1 / SNORM16_SCALE), -1.0f);
+}
+
+std::uint8_t to_unorm8(float value) noexcept
+{
+    return static_cast<std::uint8_t>(
+        std::nearbyint(std::clamp(value, 0.0f, 1.0f) * UNORM8_SCALE));
+}
+
+khepri::Vector3f cross(const khepri::Vector3f& a, const khepri::Vector3f& b) noexcept
+{
+    return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+float dot(const khepri::Vector3f& a, const khepri::Vector3f& b) noexcept
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+// Octahedral-encodes a vector; the vector needn't be normalized
+void encode_octahedral(const khepri::Vector3f& v, std::int16_t (&encoded)[2]) noexcept
+{
+    const float sum     = std::abs(v.x) + std::abs(v.y) + std::abs(v.z);
+    const float inverse = sum > 0 ? 1 / sum : 0.0f;
+    float       x       = v.x * inverse;
+    float       y       = v.y * inverse;
+    if (v.z < 0) {
+        // Fold the lower hemisphere onto the corners of the octahedron's projection
+        const float folded_x = (1 - std::abs(y)) * std::copysign(1.0f, x);
+        const float folded_y = (1 - std::abs(x)) * std::copysign(1.0f, y);
+        x                    = folded_x;
+        y                    = folded_y;
+    }
+    encoded[0] = to_snorm16(x);
+    encoded[1] = to_snorm16(y);
+}
+
+// Decodes an octahedral-encoded vector into a unit vector
+khepri::Vector3f decode_octahedral(float x, float y) noexcept
+{
+    const float z = 1 - std::abs(x) - std::abs(y);
+    const float t = std::max(-z, 0.0f);
+    x             = x >= 0 ? x - t : x + t;
+    y             = y >= 0 ? y - t : y + t;
+
+    const float length  = std::sqrt(x * x + y * y + z * z);
+    const float inverse = length > 0 ? 1 / length : 0.0f;
+    return {x * inverse, y * inverse, z * inverse};
+}
+
+void compress(const Model::Vertex& vertex, Model::CompactVertex& compact) noexcept
+{
+    compact.position = vertex.position;
+    encode_octahedral(vertex.normal, compact.normal);
+    encode_octahedral(vertex.tangent, compact.tangent);
+
+    // The lowest bit of the tangent holds the binormal's sign
+    const bool negative = dot(cross(vertex.normal, vertex.tangent), vertex.binormal) < 0;
+    compact.tangent[1]  = static_cast<std::int16_t>((compact.tangent[1] & ~1) | (negative ? 1 : 0));
+
+    for (int i = 0; i < 4; ++i) {
+        compact.uv[i][0] = float_to_half(vertex.uv[i].x);
+        compact.uv[i][1] = float_to_half(vertex.uv[i].y);
+    }
+    compact.color[0] = to_unorm8(vertex.color.r);
+    compact.color[1] = to_unorm8(vertex.color.g);
+    compact.color[2] = to_unorm8(vertex.color.b);
+    compact.color[3] = to_unorm8(vertex.color.a);
+}
+
+void decompress(const Model::CompactVertex& compact, Model::Vertex& vertex) noexcept
+{
+    vertex.position = compact.position;
+    vertex.normal =
+        decode_octahedral(from_snorm16(compact.normal[0]), from_snorm16(compact.normal[1]));
+    vertex.tangent =
+        decode_octahedral(from_snorm16(compact.tangent[0]), from_snorm16(compact.tangent[1] & ~1));
+
+    const float sign = (compact.tangent[1] & 1) != 0 ? -1.0f : 1.0f;
+    const auto  b    = cross(vertex.normal, vertex.tangent);
+    vertex.binormal  = {b.x * sign, b.y * sign, b.z * sign};
+
+    for (int i = 0; i < 4; ++i) {
+        vertex.uv[i] = {half_to_float(compact.uv[i][0]), half_to_float(compact.uv[i][1])};
+    }
+    vertex.color = {compact.color[0] * (1 / UNORM8_SCALE), compact.color[1] * (1 / UNORM8_SCALE),
+                    compact.color[2] * (1 / UNORM8_SCALE), compact.color[3] * (1 / UNORM8_SCALE)};
+}
+
+#ifdef OPENGLYPH_VERTEX_COMPRESSION_SSE
+// The SSE functions below compute the same results as the scalar functions above
+
+// Components of four vectors, one register per component
+struct Vectors4
+{
+    __m128 x;
+    __m128 y;
+    __m128 z;
+};
+
+template <typename Vertex>
+Vectors4 load(const Vertex* v, khepri::Vector3f Vertex::*member) noexcept
+{
+    return {_mm_setr_ps((v[0].*member).x, (v[1].*member).x, (v[2].*member).x, (v[3].*member).x),
+            _mm_setr_ps((v[0].*member).y, (v[1].*member).y, (v[2].*member).y, (v[3].*member).y),
+            _mm_setr_ps((v[0].*member).z, (v[1].*member).z, (v[2].*member).z, (v[3].*member).z)};
+}
+
+template <typename Vertex>
+void store(const Vectors4& vectors, Vertex* v, khepri::Vector3f Vertex::*member) noexcept
+{
+    alignas(16) float x[4];
+    alignas(16) float y[4];
+    alignas(16) float z[4];
+    _mm_store_ps(x, vectors.x);
+    _mm_store_ps(y, vectors.y);
+    _mm_store_ps(z, vectors.z);
+    for (int i = 0; i < 4; ++i) {
+        v[i].*member = {x[i], y[i], z[i]};
+    }
+}
+
+__m128 abs(__m128 v) noexcept
+{
+    return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+}
+
+// Returns a where mask is set, and b elsewhere
+__m128 select(__m128 mask, __m128 a, __m128 b) noexcept
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+__m128 reciprocal_or_zero(__m128 v) noexcept
+{
+    return _mm_and_ps(_mm_cmpgt_ps(v, _mm_setzero_ps()), _mm_div_ps(_mm_set1_ps(1), v));
+}
+
+__m128i to_snorm16(__m128 v) noexcept
+{
+    v = _mm_max_ps(_mm_min_ps(v, _mm_set1_ps(1)), _mm_set1_ps(-1));
+    return _mm_cvtps_epi32(_mm_mul_ps(v, _mm_set1_ps(SNORM16_SCALE)));
+}
+
+__m128 from_snorm16(__m128i v) noexcept
+{
+    return _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(v), _mm_set1_ps(1 / SNORM16_SCALE)),
+                      _mm_set1_ps(-1));
+}
+
+__m128 dot(const Vectors4& a, const Vectors4& b) noexcept
+{
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(a.x, b.x), _mm_mul_ps(a.y, b.y)),
+                      _mm_mul_ps(a.z, b.z));
+}
+
+Vectors4 cross(const Vectors4& a, const Vectors4& b) noexcept
+{
+    return {_mm_sub_ps(_mm_mul_ps(a.y, b.z), _mm_mul_ps(a.z, b.y)),
+            _mm_sub_ps(_mm_mul_ps(a.z, b.x), _mm_mul_ps(a.x, b.z)),
+            _mm_sub_ps(_mm_mul_ps(a.x, b.y), _mm_mul_ps(a.y, b.x))};
+}
+
+// Octahedral-encodes four vectors into signed normalized values in 32-bit lanes
+void encode_octahedral(const Vectors4& v, __m128i& encoded_x, __m128i& encoded_y) noexcept
+{
+    const __m128 sign_mask = _mm_set1_ps(-0.0f);
+    const __m128 one       = _mm_set1_ps(1);
+    const __m128 sum       = _mm_add_ps(_mm_add_ps(abs(v.x), abs(v.y)), abs(v.z));
+    const __m128 inverse   = reciprocal_or_zero(sum);
+    const __m128 x         = _mm_mul_ps(v.x, inverse);
+    const __m128 y         = _mm_mul_ps(v.y, inverse);
+
+    // 1 - |y| is not negative, so setting its sign bit multiplies it by copysign(1, x)
+    const __m128 folded_x = _mm_or_ps(_mm_sub_ps(one, abs(y)), _mm_and_ps(x, sign_mask));
+    const __m128 folded_y = _mm_or_ps(_mm_sub_ps(one, abs(x)), _mm_and_ps(y, sign_mask));
+    const __m128 lower    = _mm_cmplt_ps(v.z, _mm_setzero_ps());
+    encoded_x             = to_snorm16(select(lower, folded_x, x));
+    encoded_y             = to_snorm16(select(lower, folded_y, y));
+}
+
+Vectors4 decode_octahedral(__m128 x, __m128 y) noexcept
+{
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 z    = _mm_sub_ps(_mm_sub_ps(_mm_set1_ps(1), abs(x)), abs(y));
+    const __m128 t    = _mm_max_ps(_mm_sub_ps(zero, z), zero);
+    x                 = select(_mm_cmpge_ps(x, zero), _mm_sub_ps(x, t), _mm_add_ps(x, t));
+    y                 = select(_mm_cmpge_ps(y, zero), _mm_sub_ps(y, t), _mm_add_ps(y, t));
+
+    const Vectors4 v{x, y, z};
+    const __m128   inverse = reciprocal_or_zero(_mm_sqrt_ps(dot(v, v)));
+    return {_mm_mul_ps(x, inverse), _mm_mul_ps(y, inverse), _mm_mul_ps(z, inverse)};
+}
+
+// Converts four floats to half-precision floats in 32-bit lanes; see float_to_half()
+__m128i float_to_half(__m128 value) noexcept
+{
+    const __m128i sign     = _mm_castps_si128(_mm_and_ps(value, _mm_set1_ps(-0.0f)));
+    const __m128i bits     = _mm_xor_si128(_mm_castps_si128(value), sign);
+    const __m128i is_nan   = _mm_castps_si128(_mm_cmpunord_ps(value, value));
+    const __m128i special  = _mm_or_si128(_mm_and_si128(is_nan, _mm_set1_epi32(0x200)),
+                                          _mm_set1_epi32(0x7c00));
+    const __m128i is_large = _mm_cmpgt_epi32(bits, _mm_set1_epi32(HALF_MAX_EXPONENT - 1));
+    const __m128i is_small = _mm_cmpgt_epi32(_mm_set1_epi32(HALF_MIN_NORMAL), bits);
+
+    const __m128i magic    = _mm_set1_epi32(HALF_DENORM_MAGIC);
+    const __m128i denormal = _mm_sub_epi32(
+        _mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(bits), _mm_castsi128_ps(magic))), magic);
+
+    const __m128i mantissa_odd = _mm_and_si128(_mm_srli_epi32(bits, 13), _mm_set1_epi32(1));
+    const __m128i bias         = _mm_set1_epi32((15 << 23) - (127 << 23) + 0xfff);
+    const __m128i normal =
+        _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(bits, bias), mantissa_odd), 13);
+
+    __m128i result = _mm_or_si128(_mm_and_si128(is_small, denormal),
+                                  _mm_andnot_si128(is_small, normal));
+    result = _mm_or_si128(_mm_and_si128(is_large, special), _mm_andnot_si128(is_large, result));
+    return _mm_or_si128(result, _mm_srli_epi32(sign, 16));
+}
+
+// Converts four half-precision floats in 32-bit lanes to floats; see half_to_float()
+__m128 half_to_float(__m128i value) noexcept
+{
+    const __m128i exponent_mantissa = _mm_and_si128(value, _mm_set1_epi32(0x7fff));
+    const __m128i sign              = _mm_slli_epi32(_mm_xor_si128(value, exponent_mantissa), 16);
+    const __m128i shifted           = _mm_slli_epi32(exponent_mantissa, 13);
+    const __m128  scaled            = _mm_mul_ps(_mm_castsi128_ps(shifted),
+                                     _mm_castsi128_ps(_mm_set1_epi32(HALF_EXPONENT_ADJUST)));
+    const __m128i is_special        = _mm_cmpgt_epi32(exponent_mantissa, _mm_set1_epi32(0x7bff));
+    const __m128i special           = _mm_and_si128(is_special, _mm_set1_epi32(255 << 23));
+    return _mm_or_ps(scaled, _mm_castsi128_ps(_mm_or_si128(sign, special)));
+}
+
+// Packs eight values in 32-bit lanes in [0, 0xffff] into 16-bit lanes
+__m128i pack_u16(__m128i low, __m128i high) noexcept
+{
+    // The pack instruction saturates to signed values, so shift the values into that range first
+    const __m128i bias = _mm_set1_epi32(0x8000);
+    const __m128i packed =
+        _mm_packs_epi32(_mm_sub_epi32(low, bias), _mm_sub_epi32(high, bias));
+    return _mm_add_epi16(packed, _mm_set1_epi16(-0x8000));
+}
+
+void compress4(const Model::Vertex* vertices, Model::CompactVertex* compact) noexcept
+{
+    const auto normals   = load(vertices, &Model::Vertex::normal);
+    const auto tangents  = load(vertices, &Model::Vertex::tangent);
+    const auto binormals = load(vertices, &Model::Vertex::binormal);
+
+    __m128i normal_x;
+    __m128i normal_y;
+    __m128i tangent_x;
+    __m128i tangent_y;
+    encode_octahedral(normals, normal_x, normal_y);
+    encode_octahedral(tangents, tangent_x, tangent_y);
+
+    // The lowest bit of the tangent holds the binormal's sign
+    const __m128i one         = _mm_set1_epi32(1);
+    const __m128  orientation = dot(cross(normals, tangents), binormals);
+    const __m128  negative    = _mm_cmplt_ps(orientation, _mm_setzero_ps());
+    tangent_y                 = _mm_or_si128(_mm_andnot_si128(one, tangent_y),
+                             _mm_and_si128(_mm_castps_si128(negative), one));
+
+    alignas(16) std::int32_t encoded[4][4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(encoded[0]), normal_x);
+    _mm_store_si128(reinterpret_cast<__m128i*>(encoded[1]), normal_y);
+    _mm_store_si128(reinterpret_cast<__m128i*>(encoded[2]), tangent_x);
+    _mm_store_si128(reinterpret_cast<__m128i*>(encoded[3]), tangent_y);
+
+    for (int i = 0; i < 4; ++i) {
+        const auto& vertex = vertices[i];
+        auto&       result = compact[i];
+        result.position    = vertex.position;
+        result.normal[0]   = static_cast<std::int16_t>(encoded[0][i]);
+        result.normal[1]   = static_cast<std::int16_t>(encoded[1][i]);
+        result.tangent[0]  = static_cast<std::int16_t>(encoded[2][i]);
+        result.tangent[1]  = static_cast<std::int16_t>(encoded[3][i]);
+
+        const __m128 uv01 =
+            _mm_setr_ps(vertex.uv[0].x, vertex.uv[0].y, vertex.uv[1].x, vertex.uv[1].y);
+        const __m128 uv23 =
+            _mm_setr_ps(vertex.uv[2].x, vertex.uv[2].y, vertex.uv[3].x, vertex.uv[3].y);
+        const __m128i uvs = pack_u16(float_to_half(uv01), float_to_half(uv23));
+        static_assert(sizeof(result.uv) == sizeof(__m128i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(result.uv), uvs);
+
+        __m128 color =
+            _mm_setr_ps(vertex.color.r, vertex.color.g, vertex.color.b, vertex.color.a);
+        color = _mm_max_ps(_mm_min_ps(color, _mm_set1_ps(1)), _mm_setzero_ps());
+        const __m128i color32 = _mm_cvtps_epi32(_mm_mul_ps(color, _mm_set1_ps(UNORM8_SCALE)));
+        const __m128i color16 = _mm_packs_epi32(color32, color32);
+        const __m128i color8  = _mm_packus_epi16(color16, color16);
+        const std::int32_t packed = _mm_cvtsi128_si32(color8);
+        static_assert(sizeof(result.color) == sizeof(packed));
+        std::memcpy(result.color, &packed, sizeof(packed));
+    }
+}
+
+void decompress4(const Model::CompactVertex* compact, Model::Vertex* vertices) noexcept
+{
+    const auto component = [&](std::int16_t(Model::CompactVertex::*member)[2], int index) {
+        return _mm_setr_epi32((compact[0].*member)[index], (compact[1].*member)[index],
+                              (compact[2].*member)[index], (compact[3].*member)[index]);
+    };
+
+    const __m128i one       = _mm_set1_epi32(1);
+    const __m128i normal_x  = component(&Model::CompactVertex::normal, 0);
+    const __m128i normal_y  = component(&Model::CompactVertex::normal, 1);
+    const __m128i tangent_x = component(&Model::CompactVertex::tangent, 0);
+    const __m128i tangent_y = component(&Model::CompactVertex::tangent, 1);
+    const auto normals  = decode_octahedral(from_snorm16(normal_x), from_snorm16(normal_y));
+    const auto tangents = decode_octahedral(from_snorm16(tangent_x),
+                                            from_snorm16(_mm_andnot_si128(one, tangent_y)));
+
+    // Negate the binormals whose sign bit is set, by flipping the sign bits of their components
+    const __m128 negative = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(tangent_y, one), one));
+    const __m128 flip     = _mm_and_ps(negative, _mm_set1_ps(-0.0f));
+    auto         binormals = cross(normals, tangents);
+    binormals.x           = _mm_xor_ps(binormals.x, flip);
+    binormals.y           = _mm_xor_ps(binormals.y, flip);
+    binormals.z           = _mm_xor_ps(binormals.z, flip);
+
+    store(normals, vertices, &Model::Vertex::normal);
+    store(tangents, vertices, &Model::Vertex::tangent);
+    store(binormals, vertices, &Model::Vertex::binormal);
+
+    const __m128i zero = _mm_setzero_si128();
+    for (int i = 0; i < 4; ++i) {
+        const auto& source = compact[i];
+        auto&       vertex = vertices[i];
+        vertex.position    = source.position;
+
+        const __m128i halves = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source.uv));
+        alignas(16) float uvs[8];
+        _mm_store_ps(uvs, half_to_float(_mm_unpacklo_epi16(halves, zero)));
+        _mm_store_ps(uvs + 4, half_to_float(_mm_unpackhi_epi16(halves, zero)));
+        for (int j = 0; j < 4; ++j) {
+            vertex.uv[j] = {uvs[j * 2], uvs[j * 2 + 1]};
+        }
+
+        std::int32_t packed;
+        std::memcpy(&packed, source.color, sizeof(packed));
+        const __m128i color8  = _mm_cvtsi32_si128(packed);
+        const __m128i color32 = _mm_unpacklo_epi16(_mm_unpacklo_epi8(color8, zero), zero);
+        alignas(16) float color[4];
+        _mm_store_ps(color, _mm_mul_ps(_mm_cvtepi32_ps(color32), _mm_set1_ps(1 / UNORM8_SCALE)));
+        vertex.color = {color[0], color[1], color[2], color[3]};
+    }
+}
+#endif
+
+} // namespace
+
+void compress_vertices(gsl::span<const Model::Vertex>  vertices,
+                       gsl::span<Model::CompactVertex> compact_vertices) noexcept
+{
+    assert(vertices.size() == compact_vertices.size());
+    std::size_t i = 0;
+#ifdef OPENGLYPH_VERTEX_COMPRESSION_SSE
+    for (; i + 4 <= vertices.size(); i += 4) {
+        compress4(&vertices[i], &compact_vertices[i]);
+    }
+#endif
+    for (; i < vertices.size(); ++i) {
+        compress(vertices[i], compact_vertices[i]);
+    }
+}
+
+void decompress_vertices(gsl::span<const Model::CompactVertex> compact_vertices,
+                         gsl::span<Model::Vertex>              vertices) noexcept
+{
+    assert(vertices.size() == compact_vertices.size());
+    std::size_t i = 0;
+#ifdef OPENGLYPH_VERTEX_COMPRESSION_SSE
+    for (; i + 4 <= vertices.size(); i += 4) {
+        decompress4(&compact_vertices[i], &vertices[i]);
+    }
+#endif
+    for (; i < vertices.size(); ++i) {
+        decompress(compact_vertices[i], vertices[i]);
+    }
+}
+
+} // namespace openglyph::renderer
@@ -0,0 +1,123 @@
+#include <openglyph/utility/matrix_batch.hpp>
+#include <openglyph/utility/matrix_layout.hpp>
+
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define OPENGLYPH_MATRIX_BATCH_SSE
+#endif
+
+namespace openglyph {
+namespace {
+
+// The matrices are handled as their elements in memory order (see matrix_elements()), and the
+// product matches khepri::Matrixf::operator*
+using Elements = std::array<float, 16>;
+
+void multiply_scalar(const khepri::Matrixf& lhs, const khepri::Matrixf& rhs,
+                     khepri::Matrixf& result) noexcept
+{
+    const Elements a = matrix_elements(lhs);
+    const Elements b = matrix_elements(rhs);
+    Elements       c{};
+    for (std::size_t i = 0; i < 4; ++i) {
+        for (std::size_t j = 0; j < 4; ++j) {
+            c[i * 4 + j] = a[i * 4 + 0] * b[0 * 4 + j] + a[i * 4 + 1] * b[1 * 4 + j] +
+                           a[i * 4 + 2] * b[2 * 4 + j] + a[i * 4 + 3] * b[3 * 4 + j];
+        }
+    }
+    std::memcpy(static_cast<void*>(&result), c.data(), sizeof(c));
+}
+
+#ifdef OPENGLYPH_MATRIX_BATCH_SSE
+// Four matrices in SoA form: e[n] holds element n of each matrix
+struct SoaMatrices
+{
+    __m128 e[16];
+};
+
+// Loads four matrices into SoA form
+void load_soa(const khepri::Matrixf* matrices, SoaMatrices& soa) noexcept
+{
+    const auto* m0 = reinterpret_cast<const float*>(&matrices[0]);
+    const auto* m1 = reinterpret_cast<const float*>(&matrices[1]);
+    const auto* m2 = reinterpret_cast<const float*>(&matrices[2]);
+    const auto* m3 = reinterpret_cast<const float*>(&matrices[3]);
+    for (std::size_t row = 0; row < 4; ++row) {
+        __m128 r0 = _mm_loadu_ps(m0 + row * 4);
+        __m128 r1 = _mm_loadu_ps(m1 + row * 4);
+        __m128 r2 = _mm_loadu_ps(m2 + row * 4);
+        __m128 r3 = _mm_loadu_ps(m3 + row * 4);
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        soa.e[row * 4 + 0] = r0;
+        soa.e[row * 4 + 1] = r1;
+        soa.e[row * 4 + 2] = r2;
+        soa.e[row * 4 + 3] = r3;
+    }
+}
+
+// Stores four matrices from SoA form
+void store_soa(const SoaMatrices& soa, khepri::Matrixf* matrices) noexcept
+{
+    auto* m0 = reinterpret_cast<float*>(&matrices[0]);
+    auto* m1 = reinterpret_cast<float*>(&matrices[1]);
+    auto* m2 = reinterpret_cast<float*>(&matrices[2]);
+    auto* m3 = reinterpret_cast<float*>(&matrices[3]);
+    for (std::size_t row = 0; row < 4; ++row) {
+        __m128 r0 = soa.e[row * 4 + 0];
+        __m128 r1 = soa.e[row * 4 + 1];
+        __m128 r2 = soa.e[row * 4 + 2];
+        __m128 r3 = soa.e[row * 4 + 3];
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        _mm_storeu_ps(m0 + row * 4, r0);
+        _mm_storeu_ps(m1 + row * 4, r1);
+        _mm_storeu_ps(m2 + row * 4, r2);
+        _mm_storeu_ps(m3 + row * 4, r3);
+    }
+}
+
+void multiply_soa(const khepri::Matrixf* lhs, const khepri::Matrixf* rhs,
+                  khepri::Matrixf* result) noexcept
+{
+    SoaMatrices a;
+    SoaMatrices b;
+    SoaMatrices c;
+    load_soa(lhs, a);
+    load_soa(rhs, b);
+    for (std::size_t i = 0; i < 4; ++i) {
+        for (std::size_t j = 0; j < 4; ++j) {
+            __m128 sum     = _mm_mul_ps(a.e[i * 4 + 0], b.e[0 * 4 + j]);
+            sum            = _mm_add_ps(sum, _mm_mul_ps(a.e[i * 4 + 1], b.e[1 * 4 + j]));
+            sum            = _mm_add_ps(sum, _mm_mul_ps(a.e[i * 4 + 2], b.e[2 * 4 + j]));
+            sum            = _mm_add_ps(sum, _mm_mul_ps(a.e[i * 4 + 3], b.e[3 * 4 + j]));
+            c.e[i * 4 + j] = sum;
+        }
+    }
+    store_soa(c, result);
+}
+#endif
+
+} // namespace
+
+void multiply_batch(gsl::span<const khepri::Matrixf> lhs, gsl::span<const khepri::Matrixf> rhs,
+                    gsl::span<khepri::Matrixf> result)
+{
+    if (lhs.size() != rhs.size() || lhs.size() != result.size()) {
+        throw std::invalid_argument("matrix batch sizes do not match");
+    }
+
+    std::size_t i = 0;
+#ifdef OPENGLYPH_MATRIX_BATCH_SSE
+    for (; i + 4 <= result.size(); i += 4) {
+        multiply_soa(&lhs[i], &rhs[i], &result[i]);
+    }
+#endif
+    for (; i < result.size(); ++i) {
+        multiply_scalar(lhs[i], rhs[i], result[i]);
+    }
+}
+
+} // namespace openglyph
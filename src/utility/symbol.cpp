@@ -0,0 +1,171 @@
+#include <openglyph/utility/symbol.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace openglyph {
+namespace {
+
+constexpr char fold(char c) noexcept
+{
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+// 32-bit FNV-1a hash of the case-folded string
+std::uint32_t case_insensitive_hash(std::string_view str) noexcept
+{
+    std::uint32_t hash = 0x811c9dc5u;
+    for (const char c : str) {
+        hash = (hash ^ static_cast<std::uint8_t>(fold(c))) * 0x01000193u;
+    }
+    return hash;
+}
+
+struct CaseInsensitiveHash
+{
+    std::size_t operator()(std::string_view str) const noexcept
+    {
+        return case_insensitive_hash(str);
+    }
+};
+
+struct CaseInsensitiveEqual
+{
+    bool operator()(std::string_view s1, std::string_view s2) const noexcept
+    {
+        return s1.size() == s2.size() &&
+               std::equal(s1.begin(), s1.end(), s2.begin(),
+                          [](char c1, char c2) { return fold(c1) == fold(c2); });
+    }
+};
+
+class SymbolTable
+{
+public:
+    struct Entry
+    {
+        std::string_view str;
+        std::uint32_t    hash;
+    };
+
+    static SymbolTable& instance()
+    {
+        static SymbolTable table;
+        return table;
+    }
+
+    Symbol::Id intern(std::string_view str)
+    {
+        if (auto id = find(str)) {
+            return *id;
+        }
+
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        if (const auto it = m_ids.find(str); it != m_ids.end()) {
+            return it->second;
+        }
+
+        const auto id = m_count;
+        if ((id >> CHUNK_BITS) >= MAX_CHUNKS) {
+            throw std::length_error("symbol table is full");
+        }
+        auto& chunk = m_chunks[id >> CHUNK_BITS];
+        if (!chunk) {
+            chunk = std::make_unique<Entry[]>(CHUNK_SIZE);
+        }
+
+        const auto stored_str        = store(str);
+        chunk[id & (CHUNK_SIZE - 1)] = {stored_str, case_insensitive_hash(stored_str)};
+        m_ids.emplace(stored_str, id);
+        ++m_count;
+        return id;
+    }
+
+    std::optional<Symbol::Id> find(std::string_view str) const
+    {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        if (const auto it = m_ids.find(str); it != m_ids.end()) {
+            return it->second;
+        }
+        return {};
+    }
+
+    const Entry& entry(Symbol::Id id) const noexcept
+    {
+        // Entries are never moved or modified after creation, and a symbol's ID can only be
+        // obtained after its entry was created, so this does not need to lock.
+        assert(id < MAX_CHUNKS * CHUNK_SIZE && m_chunks[id >> CHUNK_BITS]);
+        return m_chunks[id >> CHUNK_BITS][id & (CHUNK_SIZE - 1)];
+    }
+
+private:
+    static constexpr std::size_t CHUNK_BITS        = 12;
+    static constexpr std::size_t CHUNK_SIZE        = std::size_t{1} << CHUNK_BITS;
+    static constexpr std::size_t MAX_CHUNKS        = 4096;
+    static constexpr std::size_t STRING_BLOCK_SIZE = 64 * 1024;
+
+    SymbolTable()
+    {
+        // ID 0 is the empty symbol
+        m_chunks[0]    = std::make_unique<Entry[]>(CHUNK_SIZE);
+        m_chunks[0][0] = {std::string_view(), case_insensitive_hash({})};
+        m_ids.emplace(std::string_view(), 0);
+    }
+
+    // Copies a string into the string storage. Must be called with the lock held.
+    std::string_view store(std::string_view str)
+    {
+        if (m_blocks.empty() || m_block_used + str.size() > STRING_BLOCK_SIZE) {
+            // Strings that exceed the block size get a block of their own
+            m_blocks.push_back(std::make_unique<char[]>(std::max(str.size(), STRING_BLOCK_SIZE)));
+            m_block_used = 0;
+        }
+        char* dest = m_blocks.back().get() + m_block_used;
+        std::memcpy(dest, str.data(), str.size());
+        m_block_used += str.size();
+        return {dest, str.size()};
+    }
+
+    using IdMap = std::unordered_map<std::string_view, Symbol::Id, CaseInsensitiveHash,
+                                     CaseInsensitiveEqual>;
+
+    mutable std::shared_mutex                        m_mutex;
+    IdMap                                            m_ids;
+    std::array<std::unique_ptr<Entry[]>, MAX_CHUNKS> m_chunks;
+    Symbol::Id                                       m_count{1};
+    std::vector<std::unique_ptr<char[]>>             m_blocks;
+    std::size_t                                      m_block_used{0};
+};
+
+} // namespace
+
+Symbol::Symbol(std::string_view str) : m_id(str.empty() ? 0 : SymbolTable::instance().intern(str))
+{}
+
+std::optional<Symbol> Symbol::find(std::string_view str)
+{
+    if (auto id = SymbolTable::instance().find(str)) {
+        return Symbol(*id);
+    }
+    return {};
+}
+
+std::string_view Symbol::str() const noexcept
+{
+    return SymbolTable::instance().entry(m_id).str;
+}
+
+std::uint32_t Symbol::hash() const noexcept
+{
+    return SymbolTable::instance().entry(m_id).hash;
+}
+
+} // namespace openglyph
@@ -0,0 +1,152 @@
+#include <openglyph/utility/thread_pool.hpp>
+
+#include <algorithm>
+#include <utility>
+
+namespace openglyph {
+namespace {
+// The pool whose task is being run by the current thread, if any
+thread_local const ThreadPool* s_current_pool = nullptr;
+} // namespace
+
+ThreadPool::ThreadPool(std::size_t num_threads)
+{
+    if (num_threads == 0) {
+        num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    m_workers.reserve(num_threads - 1);
+    for (std::size_t i = 1; i < num_threads; ++i) {
+        m_workers.emplace_back([this] { worker_main(); });
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_work_available.notify_all();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::parallel_for(std::size_t count, const std::function<void(std::size_t)>& task)
+{
+    if (count == 0) {
+        return;
+    }
+
+    if (s_current_pool == this) {
+        // Nested job: this thread is part of the outer job, so waiting for the pool would never
+        // finish. Run the tasks here instead.
+        std::exception_ptr exception;
+        for (std::size_t index = 0; index < count; ++index) {
+            try {
+                task(index);
+            } catch (...) {
+                if (!exception) {
+                    exception = std::current_exception();
+                }
+            }
+        }
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> job_lock(m_job_mutex);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_task      = &task;
+        m_count     = count;
+        m_next      = 0;
+        m_exception = nullptr;
+        ++m_job;
+    }
+    m_work_available.notify_all();
+
+    run_tasks();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_work_done.wait(lock, [this] { return m_next >= m_count && m_active == 0; });
+    m_task = nullptr;
+    if (m_exception) {
+        std::rethrow_exception(std::exchange(m_exception, nullptr));
+    }
+}
+
+void ThreadPool::enqueue(std::function<void()> task)
+{
+    if (m_workers.empty()) {
+        task();
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_background_tasks.push_back(std::move(task));
+    }
+    m_work_available.notify_one();
+}
+
+void ThreadPool::worker_main()
+{
+    std::uint64_t last_job = 0;
+    for (;;) {
+        std::function<void()> background_task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_work_available.wait(lock, [&] {
+                return m_stop || m_job != last_job || !m_background_tasks.empty();
+            });
+            if (m_stop) {
+                return;
+            }
+            if (m_job != last_job) {
+                // Jobs take precedence over background tasks
+                last_job = m_job;
+            } else {
+                background_task = std::move(m_background_tasks.front());
+                m_background_tasks.pop_front();
+            }
+        }
+        if (background_task) {
+            auto* const previous_pool = std::exchange(s_current_pool, this);
+            background_task();
+            s_current_pool = previous_pool;
+        } else {
+            run_tasks();
+        }
+    }
+}
+
+void ThreadPool::run_tasks()
+{
+    auto* const previous_pool = std::exchange(s_current_pool, this);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    ++m_active;
+    while (m_task != nullptr && m_next < m_count) {
+        const auto  index = m_next++;
+        const auto* task  = m_task;
+        lock.unlock();
+        try {
+            (*task)(index);
+        } catch (...) {
+            lock.lock();
+            if (!m_exception) {
+                m_exception = std::current_exception();
+            }
+            lock.unlock();
+        }
+        lock.lock();
+    }
+    if (--m_active == 0 && m_next >= m_count) {
+        m_work_done.notify_all();
+    }
+    s_current_pool = previous_pool;
+}
+
+} // namespace openglyph
@@ -0,0 +1,313 @@
+#include <benchmarks/null_renderer.hpp>
+#include <gtest/gtest.h>
+#include <khepri/scene/scene_object.hpp>
+#include <openglyph/game/behaviors/render_behavior.hpp>
+#include <openglyph/game/render_list.hpp>
+#include <openglyph/utility/matrix_layout.hpp>
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <variant>
+#include <vector>
+
+using openglyph::RenderBehavior;
+using openglyph::RenderList;
+using openglyph::Symbol;
+using openglyph::benchmarks::NullRenderer;
+using openglyph::renderer::RenderModel;
+
+namespace {
+constexpr std::size_t OBJECT_COUNT = 4;
+constexpr std::size_t MESH_COUNT   = 2;
+
+class RenderListTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        material = renderer.create_material({});
+
+        std::vector<RenderModel::Mesh> meshes;
+        for (std::size_t i = 0; i < MESH_COUNT; ++i) {
+            RenderModel::Mesh mesh{};
+            mesh.name         = Symbol("RenderListTest_Mesh" + std::to_string(i));
+            mesh.render_mesh  = renderer.create_mesh({});
+            mesh.material     = material.get();
+            mesh.visible      = true;
+            mesh.bounding_box = {{-1, -1, -1}, {1, 1, 1}};
+            meshes.push_back(std::move(mesh));
+        }
+        model = std::make_unique<RenderModel>(std::move(meshes));
+
+        // Object i is at x = i
+        for (std::size_t i = 0; i < OBJECT_COUNT; ++i) {
+            objects[i].create_behavior<RenderBehavior>(*model);
+            objects[i].position({static_cast<double>(i), 0, 0});
+        }
+    }
+
+    static RenderBehavior& render(khepri::scene::SceneObject& object)
+    {
+        return *object.behavior<RenderBehavior>();
+    }
+
+    // Returns the x coordinate of every instance's translation, in ascending order
+    static std::vector<float>
+    instance_xs(gsl::span<const khepri::renderer::MeshInstance> instances)
+    {
+        std::vector<float> xs;
+        for (const auto& instance : instances) {
+            xs.push_back(openglyph::matrix_elements(instance.transform)[12]);
+        }
+        std::sort(xs.begin(), xs.end());
+        return xs;
+    }
+
+    // Returns what #instance_xs() should return for objects at the given x coordinates
+    static std::vector<float> expected_xs(std::vector<float> xs)
+    {
+        std::vector<float> result;
+        for (const auto x : xs) {
+            result.insert(result.end(), MESH_COUNT, x);
+        }
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    NullRenderer                                         renderer;
+    std::unique_ptr<khepri::renderer::Material>          material;
+    std::unique_ptr<RenderModel>                         model;
+    std::array<khepri::scene::SceneObject, OBJECT_COUNT> objects;
+    RenderList                                           list;
+};
+} // namespace
+
+TEST_F(RenderListTest, AddMoveUpdateRemove_KeepsInstancesCorrect)
+{
+    for (auto& object : objects) {
+        list.add(object);
+    }
+    EXPECT_EQ(list.size(), OBJECT_COUNT);
+    EXPECT_EQ(list.mesh_count(), OBJECT_COUNT * MESH_COUNT);
+    EXPECT_EQ(instance_xs(list.instances()), expected_xs({0, 1, 2, 3}));
+
+    // Moving and reporting an object updates its instances in place
+    objects[1].position({10, 0, 0});
+    list.update(objects[1]);
+    EXPECT_EQ(instance_xs(list.instances()), expected_xs({0, 10, 2, 3}));
+
+    // Removing an object moves the last object into its place
+    list.remove(objects[0]);
+    EXPECT_EQ(list.size(), OBJECT_COUNT - 1);
+    EXPECT_EQ(instance_xs(list.instances()), expected_xs({10, 2, 3}));
+
+    // Moving the moved object still updates the right instances
+    objects[3].position({30, 0, 0});
+    list.update(objects[3]);
+    EXPECT_EQ(instance_xs(list.instances()), expected_xs({10, 2, 30}));
+
+    // Hidden objects have no instances
+    render(objects[2]).visible(false);
+    list.update(objects[2]);
+    EXPECT_EQ(instance_xs(list.instances()), expected_xs({10, 30}));
+    render(objects[2]).visible(true);
+    list.update(objects[2]);
+    EXPECT_EQ(instance_xs(list.instances()), expected_xs({10, 2, 30}));
+
+    // Removing an object twice, or an object that was never added, does nothing
+    list.remove(objects[0]);
+    khepri::scene::SceneObject other;
+    list.remove(other);
+    EXPECT_EQ(list.size(), OBJECT_COUNT - 1);
+
+    for (auto& object : objects) {
+        list.remove(object);
+    }
+    EXPECT_EQ(list.size(), 0);
+    EXPECT_EQ(list.mesh_count(), 0);
+    EXPECT_TRUE(list.instances().empty());
+}
+
+TEST_F(RenderListTest, DetectChanges_PicksUpUnreportedChanges)
+{
+    for (auto& object : objects) {
+        list.add(object);
+    }
+    list.instances();
+    EXPECT_TRUE(list.detect_changes().empty());
+
+    // An object that moves without update() is found and drawn at its new transform
+    objects[2].position({20, 0, 0});
+    const auto changed = list.detect_changes();
+    ASSERT_EQ(changed.size(), 1);
+    EXPECT_EQ(changed[0], &objects[2]);
+    EXPECT_EQ(instance_xs(list.instances()), expected_xs({0, 1, 20, 3}));
+    EXPECT_TRUE(list.detect_changes().empty());
+
+    // Setting the same transform again is not a change
+    objects[2].position({20, 0, 0});
+    EXPECT_TRUE(list.detect_changes().empty());
+
+    // Visibility, scale and parameter overrides are found as well
+    render(objects[0]).scale(2.0);
+    render(objects[1]).visible(false);
+    render(objects[3]).override_param(0, {"Color", 1.0f});
+    EXPECT_EQ(list.detect_changes().size(), 3);
+    EXPECT_EQ(instance_xs(list.instances()), expected_xs({0, 20, 3}));
+    EXPECT_FLOAT_EQ(openglyph::matrix_elements(list.instances()[0].transform)[0], 2.0f);
+    EXPECT_TRUE(list.detect_changes().empty());
+}
+
+TEST_F(RenderListTest, DetectChanges_AfterUpdateFindsNothing)
+{
+    for (auto& object : objects) {
+        list.add(object);
+    }
+    objects[0].position({5, 0, 0});
+    list.update(objects[0]);
+    list.instances();
+    EXPECT_TRUE(list.detect_changes().empty());
+#ifndef NDEBUG
+    list.verify_unchanged();
+#endif
+}
+
+TEST_F(RenderListTest, RemovedObjectsHandle_DoesNotResolveAfterSlotReuse)
+{
+    list.add(objects[0]);
+    list.add(objects[1]);
+    const auto handle = render(objects[0]).render_handle();
+    ASSERT_TRUE(handle.valid());
+
+    // The removed object's slot is reused by the next object, with a new generation
+    list.remove(objects[0]);
+    list.add(objects[2]);
+    const auto reused = render(objects[2]).render_handle();
+    EXPECT_EQ(reused.index, handle.index);
+    EXPECT_NE(reused.generation, handle.generation);
+
+    // The removed object still holds its old handle, which no longer finds anything
+    EXPECT_EQ(render(objects[0]).render_handle().index, handle.index);
+    list.remove(objects[0]);
+    EXPECT_EQ(list.size(), 2);
+    objects[0].position({5, 0, 0});
+    list.update(objects[0]);
+    EXPECT_EQ(list.size(), 3);
+    EXPECT_EQ(instance_xs(list.instances()), expected_xs({1, 2, 5}));
+}
+
+TEST_F(RenderListTest, SwapRemove_KeepsHandlesOfMovedObjects)
+{
+    for (auto& object : objects) {
+        list.add(object);
+    }
+    const auto handle = render(objects[3]).render_handle();
+
+    // Removing the first object moves the last one into its place, behind the same handle
+    list.remove(objects[0]);
+    EXPECT_EQ(render(objects[3]).render_handle().index, handle.index);
+    EXPECT_EQ(render(objects[3]).render_handle().generation, handle.generation);
+
+    render(objects[3]).visible(false);
+    list.update(objects[3]);
+    EXPECT_EQ(instance_xs(list.instances()), expected_xs({1, 2}));
+
+    list.remove(objects[3]);
+    list.remove(objects[1]);
+    EXPECT_EQ(list.size(), 1);
+    EXPECT_EQ(instance_xs(list.instances()), expected_xs({2}));
+}
+
+TEST_F(RenderListTest, ParamOverlays_AreRecycledWithoutLeakingParameters)
+{
+    // Returns the values of the "Color" parameter of all instances, in ascending order
+    const auto colors = [&] {
+        std::vector<float> values;
+        for (const auto& instance : list.instances()) {
+            for (const auto& param : instance.material_params) {
+                if (param.name == "Color") {
+                    values.push_back(std::get<float>(param.value));
+                }
+            }
+        }
+        std::sort(values.begin(), values.end());
+        return values;
+    };
+
+    render(objects[0]).override_param(0, {"Color", 1.0f});
+    render(objects[1]).override_param(1, {"Color", 2.0f});
+    list.add(objects[0]);
+    list.add(objects[1]);
+    list.add(objects[2]);
+    EXPECT_EQ(colors(), (std::vector<float>{1.0f, 2.0f}));
+
+    // The next object that overrides parameters reuses the removed object's overlays, but only
+    // gets its own parameters
+    list.remove(objects[0]);
+    render(objects[3]).override_param(1, {"Color", 3.0f});
+    list.add(objects[3]);
+    EXPECT_EQ(colors(), (std::vector<float>{2.0f, 3.0f}));
+
+    // Clearing an object's overrides releases its overlays as well
+    render(objects[1]).clear_param_overrides();
+    list.update(objects[1]);
+    render(objects[2]).override_param(0, {"Color", 4.0f});
+    list.update(objects[2]);
+    EXPECT_EQ(colors(), (std::vector<float>{3.0f, 4.0f}));
+}
+
+TEST_F(RenderListTest, ObjectsWhoseHandleIsReplaced_AreStillFound)
+{
+    for (auto& object : objects) {
+        list.add(object);
+    }
+
+    // Adding the object to another list replaces its handle
+    RenderList other_list;
+    other_list.add(objects[1]);
+
+    objects[1].position({10, 0, 0});
+    list.update(objects[1]);
+    EXPECT_EQ(list.size(), OBJECT_COUNT);
+    EXPECT_EQ(instance_xs(list.instances()), expected_xs({0, 10, 2, 3}));
+
+    // Removal moves the last object into its place, which must keep being found as well
+    list.remove(objects[0]);
+    list.remove(objects[1]);
+    EXPECT_EQ(list.size(), OBJECT_COUNT - 2);
+    objects[3].position({30, 0, 0});
+    list.update(objects[3]);
+    EXPECT_EQ(instance_xs(list.instances()), expected_xs({2, 30}));
+    EXPECT_EQ(other_list.size(), 1);
+}
+
+TEST_F(RenderListTest, Cull_RestrictsInstancesToVisibleObjects)
+{
+    for (auto& object : objects) {
+        list.add(object);
+    }
+
+    // Objects without a RenderBehavior and objects that are not in the list are ignored
+    khepri::scene::SceneObject plain;
+    khepri::scene::SceneObject other;
+    other.create_behavior<RenderBehavior>(*model);
+    const std::vector<const khepri::scene::SceneObject*> visible{&objects[3], &plain, &other,
+                                                                 &objects[1]};
+    list.cull(visible);
+    EXPECT_EQ(instance_xs(list.sorted_instances({0, 0, 0})), expected_xs({1, 3}));
+
+    // Changes to visible objects are picked up while culled
+    objects[3].position({30, 0, 0});
+    list.update(objects[3]);
+    EXPECT_EQ(instance_xs(list.sorted_instances({0, 0, 0})), expected_xs({1, 30}));
+
+    // Removing an object resets the restriction, since the culled indices may have moved
+    list.remove(objects[0]);
+    EXPECT_EQ(instance_xs(list.sorted_instances({0, 0, 0})), expected_xs({1, 2, 30}));
+
+    list.cull(visible);
+    EXPECT_EQ(instance_xs(list.sorted_instances({0, 0, 0})), expected_xs({1, 30}));
+    list.reset_culling();
+    EXPECT_EQ(instance_xs(list.sorted_instances({0, 0, 0})), expected_xs({1, 2, 30}));
+}
@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include <khepri/scene/scene_object.hpp>
+#include <openglyph/game/spatial_index.hpp>
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+using openglyph::SpatialIndex;
+using openglyph::renderer::BoundingBox;
+using openglyph::renderer::Frustum;
+
+namespace {
+constexpr std::size_t OBJECT_COUNT = 100;
+
+// Returns a unit box around a point on the x axis
+BoundingBox box_at(float x)
+{
+    return {{x - 0.5f, -0.5f, -0.5f}, {x + 0.5f, 0.5f, 0.5f}};
+}
+
+class SpatialIndexTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // Object i is at x = 10 * i
+        for (std::size_t i = 0; i < OBJECT_COUNT; ++i) {
+            ids[i] = index.insert(box_at(10.0f * i), objects[i]);
+        }
+    }
+
+    // Returns the indices of the objects found by a query, in ascending order
+    template <typename Query>
+    std::vector<std::size_t> found(Query&& query)
+    {
+        std::vector<std::size_t> result;
+        query([&](khepri::scene::SceneObject& object) {
+            result.push_back(static_cast<std::size_t>(&object - objects.data()));
+        });
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    std::array<khepri::scene::SceneObject, OBJECT_COUNT> objects;
+    std::array<SpatialIndex::Id, OBJECT_COUNT>           ids{};
+    SpatialIndex                                         index;
+};
+} // namespace
+
+TEST_F(SpatialIndexTest, Insert_KeepsTreeBalanced)
+{
+    EXPECT_EQ(index.size(), OBJECT_COUNT);
+    // A height-balanced tree of 100 leaves is at most 1.44 * log2(100) high
+    EXPECT_LE(index.height(), 10);
+    for (std::size_t i = 0; i < OBJECT_COUNT; ++i) {
+        EXPECT_TRUE(index.contains(ids[i], objects[i]));
+    }
+}
+
+TEST_F(SpatialIndexTest, QueryBox_FindsIntersectingObjects)
+{
+    const BoundingBox box{{95, -1, -1}, {125, 1, 1}};
+    EXPECT_EQ(found([&](auto&& fn) { index.query_box(box, fn); }),
+              (std::vector<std::size_t>{10, 11, 12}));
+}
+
+TEST_F(SpatialIndexTest, QuerySphereAndRay_FindIntersectingObjects)
+{
+    EXPECT_EQ(found([&](auto&& fn) { index.query_sphere({200, 3, 0}, 3, fn); }),
+              (std::vector<std::size_t>{20}));
+    EXPECT_EQ(found([&](auto&& fn) { index.query_ray({505, 10, 0}, {0, -1, 0}, 20, fn); }),
+              (std::vector<std::size_t>{}));
+    EXPECT_EQ(found([&](auto&& fn) { index.query_ray({500, 10, 0}, {0, -1, 0}, 20, fn); }),
+              (std::vector<std::size_t>{50}));
+}
+
+TEST_F(SpatialIndexTest, QueryFrustum_FindsObjectsInside)
+{
+    // Orthographic frustum of x in [-1, 21], y and z in [-1, 1]
+    const float scale   = 2.0f / 22;
+    const auto  frustum = Frustum::from_matrices(khepri::Matrixf{
+        scale, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, -1 + scale, 0, 0, 1});
+    EXPECT_EQ(found([&](auto&& fn) { index.query_frustum(frustum, fn); }),
+              (std::vector<std::size_t>{0, 1, 2}));
+}
+
+TEST_F(SpatialIndexTest, Update_MovesObject)
+{
+    // Moving within the enlarged box does not change the tree
+    EXPECT_FALSE(index.update(ids[5], box_at(50.5f)));
+    EXPECT_TRUE(index.update(ids[5], box_at(1000)));
+    EXPECT_TRUE(index.contains(ids[5], objects[5]));
+
+    const BoundingBox old_area{{45, -1, -1}, {55, 1, 1}};
+    const BoundingBox new_area{{995, -1, -1}, {1005, 1, 1}};
+    EXPECT_EQ(found([&](auto&& fn) { index.query_box(old_area, fn); }),
+              (std::vector<std::size_t>{}));
+    EXPECT_EQ(found([&](auto&& fn) { index.query_box(new_area, fn); }),
+              (std::vector<std::size_t>{5}));
+}
+
+TEST_F(SpatialIndexTest, Remove_RemovesObject)
+{
+    for (std::size_t i = 0; i < OBJECT_COUNT; i += 2) {
+        index.remove(ids[i]);
+        EXPECT_FALSE(index.contains(ids[i], objects[i]));
+    }
+    EXPECT_EQ(index.size(), OBJECT_COUNT / 2);
+
+    const BoundingBox box{{-1, -1, -1}, {51, 1, 1}};
+    EXPECT_EQ(found([&](auto&& fn) { index.query_box(box, fn); }),
+              (std::vector<std::size_t>{1, 3, 5}));
+
+    // Removed IDs are reused for new objects
+    khepri::scene::SceneObject object;
+    const auto                 id = index.insert(box_at(0), object);
+    EXPECT_TRUE(index.contains(id, object));
+    EXPECT_FALSE(index.contains(id, objects[0]));
+}
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include <openglyph/renderer/frustum.hpp>
+
+using openglyph::renderer::BoundingBox;
+using openglyph::renderer::Frustum;
+
+namespace {
+// Returns a unit box around a point
+BoundingBox box_at(float x, float y, float z)
+{
+    return {{x - 0.5f, y - 0.5f, z - 0.5f}, {x + 0.5f, y + 0.5f, z + 0.5f}};
+}
+
+// Returns a projection for row vectors with a 90 degree field of view, looking down -z.
+// z_scale and z_offset map view-space z to clip-space z.
+khepri::Matrixf perspective(float z_scale, float z_offset)
+{
+    return {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, z_scale, -1, 0, 0, z_offset, 0};
+}
+} // namespace
+
+TEST(FrustumTest, Orthographic_ContainsUnitCube)
+{
+    const auto frustum = Frustum::from_matrices(khepri::Matrixf{
+        1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1});
+
+    EXPECT_EQ(frustum.classify({{-0.5f, -0.5f, -0.5f}, {0.5f, 0.5f, 0.5f}}),
+              Frustum::Containment::inside);
+    EXPECT_EQ(frustum.classify(box_at(1, 0, 0)), Frustum::Containment::intersects);
+    EXPECT_EQ(frustum.classify(box_at(3, 0, 0)), Frustum::Containment::outside);
+    EXPECT_EQ(frustum.classify(box_at(0, 0, -3)), Frustum::Containment::outside);
+}
+
+TEST(FrustumTest, Perspective_ClassifiesBoxes)
+{
+    // OpenGL-style depth range with near = 1 and far = 100
+    const float near    = 1;
+    const float far     = 100;
+    const auto  frustum = Frustum::from_matrices(
+        perspective((far + near) / (near - far), 2 * far * near / (near - far)));
+
+    EXPECT_EQ(frustum.classify(box_at(0, 0, -10)), Frustum::Containment::inside);
+    EXPECT_EQ(frustum.classify(box_at(0, 0, 10)), Frustum::Containment::outside);
+    EXPECT_EQ(frustum.classify(box_at(20, 0, -10)), Frustum::Containment::outside);
+    EXPECT_EQ(frustum.classify(box_at(0, 0, -200)), Frustum::Containment::outside);
+}
+
+TEST(FrustumTest, InfiniteFarPlane_ClassifiesBoxes)
+{
+    // Direct3D-style depth range with near = 1 and no far plane
+    const auto frustum = Frustum::from_matrices(perspective(-1, -1));
+
+    EXPECT_EQ(frustum.classify(box_at(0, 0, -10)), Frustum::Containment::inside);
+    EXPECT_EQ(frustum.classify(box_at(0, 0, -1e6f)), Frustum::Containment::inside);
+    EXPECT_EQ(frustum.classify(box_at(0, 0, 10)), Frustum::Containment::outside);
+    EXPECT_EQ(frustum.classify(box_at(20, 0, -10)), Frustum::Containment::outside);
+    EXPECT_EQ(frustum.classify(box_at(0, -20, -10)), Frustum::Containment::outside);
+}
@@ -0,0 +1,104 @@
+#include <benchmarks/null_renderer.hpp>
+#include <gtest/gtest.h>
+#include <openglyph/renderer/material_store.hpp>
+
+#include <string>
+#include <vector>
+
+using openglyph::Symbol;
+using openglyph::benchmarks::NullRenderer;
+using openglyph::renderer::MaterialDesc;
+using openglyph::renderer::MaterialStore;
+
+namespace {
+// Returns a material with a shader and a texture that are named after the material
+MaterialDesc material_desc(const std::string& name)
+{
+    MaterialDesc desc;
+    desc.name   = Symbol(name);
+    desc.shader = name + "_Shader";
+    desc.properties.push_back({Symbol("BaseTexture"), name + "_Texture"});
+    desc.properties.push_back({Symbol("Shininess"), 1.0f});
+    return desc;
+}
+
+class MaterialStoreTest : public ::testing::Test
+{
+protected:
+    MaterialStore create_store(MaterialStore::Mode mode)
+    {
+        return MaterialStore(
+            renderer,
+            [this](std::string_view name) -> khepri::renderer::Shader* {
+                loaded_shaders.emplace_back(name);
+                return nullptr;
+            },
+            [this](std::string_view name) -> khepri::renderer::Texture* {
+                loaded_textures.emplace_back(name);
+                return nullptr;
+            },
+            mode);
+    }
+
+    const std::vector<MaterialDesc> descs{material_desc("StoreTest_A"),
+                                          material_desc("StoreTest_B")};
+
+    NullRenderer             renderer;
+    std::vector<std::string> loaded_shaders;
+    std::vector<std::string> loaded_textures;
+};
+} // namespace
+
+TEST_F(MaterialStoreTest, Immediate_LoadsOnRegister)
+{
+    auto store = create_store(MaterialStore::Mode::immediate);
+    store.register_materials(descs);
+
+    EXPECT_EQ(renderer.counters().materials, 2);
+    EXPECT_EQ(loaded_shaders,
+              (std::vector<std::string>{"StoreTest_A_Shader", "StoreTest_B_Shader"}));
+    EXPECT_EQ(loaded_textures.size(), 2);
+}
+
+TEST_F(MaterialStoreTest, Lazy_DefersLoadingUntilGet)
+{
+    auto store = create_store(MaterialStore::Mode::lazy);
+    store.register_materials(descs);
+
+    // Registering only stores the descriptions; their information is available right away
+    EXPECT_EQ(renderer.counters().materials, 0);
+    EXPECT_TRUE(loaded_shaders.empty());
+    EXPECT_TRUE(loaded_textures.empty());
+    ASSERT_NE(store.info("StoreTest_A"), nullptr);
+    EXPECT_EQ(store.info("StoreTest_A")->properties.size(), 2);
+    EXPECT_EQ(renderer.counters().materials, 0);
+
+    // The first get() of a material loads its shader and textures, and only those
+    auto* material = store.get("storetest_a");
+    ASSERT_NE(material, nullptr);
+    EXPECT_EQ(renderer.counters().materials, 1);
+    EXPECT_EQ(loaded_shaders, std::vector<std::string>{"StoreTest_A_Shader"});
+    EXPECT_EQ(loaded_textures, std::vector<std::string>{"StoreTest_A_Texture"});
+
+    // Later calls return the same material without loading anything
+    EXPECT_EQ(store.get("StoreTest_A"), material);
+    EXPECT_EQ(renderer.counters().materials, 1);
+    EXPECT_EQ(loaded_shaders.size(), 1);
+    EXPECT_EQ(loaded_textures.size(), 1);
+
+    EXPECT_NE(store.get("StoreTest_B"), nullptr);
+    EXPECT_EQ(renderer.counters().materials, 2);
+    EXPECT_EQ(loaded_shaders.size(), 2);
+    EXPECT_EQ(loaded_textures.size(), 2);
+}
+
+TEST_F(MaterialStoreTest, Lazy_UnknownMaterialLoadsNothing)
+{
+    auto store = create_store(MaterialStore::Mode::lazy);
+    store.register_materials(descs);
+
+    EXPECT_EQ(store.get("StoreTest_Unknown"), nullptr);
+    EXPECT_EQ(renderer.counters().materials, 0);
+    EXPECT_TRUE(loaded_shaders.empty());
+    EXPECT_TRUE(loaded_textures.empty());
+}
@@ -0,0 +1,179 @@
+#include <benchmarks/null_renderer.hpp>
+#include <gtest/gtest.h>
+#include <openglyph/renderer/model_creator.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using openglyph::Symbol;
+using openglyph::benchmarks::NullRenderer;
+using openglyph::renderer::Model;
+using openglyph::renderer::ModelCreator;
+using openglyph::renderer::RenderModel;
+
+namespace {
+using khepri::renderer::MeshDesc;
+
+// Returns a mesh with a triangle at the given height, drawn with the given indices
+MeshDesc create_mesh_desc(float height, std::vector<MeshDesc::Index> indices = {0, 1, 2})
+{
+    MeshDesc desc;
+    desc.vertices.resize(3);
+    desc.vertices[1].position = {1, 0, height};
+    desc.vertices[2].position = {0, 1, height};
+    desc.indices              = std::move(indices);
+    return desc;
+}
+
+// Returns the size of a mesh's vertices and indices, in bytes
+std::size_t content_bytes(const MeshDesc& desc)
+{
+    return desc.vertices.size() * sizeof(MeshDesc::Vertex) +
+           desc.indices.size() * sizeof(MeshDesc::Index);
+}
+
+// Returns a mesh of a model with a triangle at the given height
+Model::Mesh create_model_mesh(const std::string& name, unsigned int lod, float height)
+{
+    Model::Material material{};
+    material.name = Symbol("Mesh.fx");
+    material.vertices.resize(3);
+    material.vertices[1].position = {1, 0, height};
+    material.vertices[2].position = {0, 1, height};
+    material.indices              = {0, 1, 2};
+
+    Model::Mesh mesh{};
+    mesh.name         = Symbol(name);
+    mesh.lod          = lod;
+    mesh.visible      = true;
+    mesh.bounding_box = {{0, 0, 0}, {1, 1, 1}};
+    mesh.materials.push_back(std::move(material));
+    return mesh;
+}
+
+class ModelCreatorTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        material = renderer.create_material({});
+        creator  = std::make_unique<ModelCreator>(
+            renderer, [this](Symbol) { return material.get(); },
+            [](std::string_view) -> khepri::renderer::Texture* { return nullptr; });
+    }
+
+    NullRenderer                                renderer;
+    std::unique_ptr<khepri::renderer::Material> material;
+    std::unique_ptr<ModelCreator>               creator;
+};
+} // namespace
+
+TEST_F(ModelCreatorTest, CreateMesh_SharesMeshesWithSameContents)
+{
+    creator->deduplicate_meshes(true);
+    const auto desc = create_mesh_desc(1);
+
+    auto first  = creator->create_mesh(desc);
+    auto second = creator->create_mesh(desc);
+    auto other  = creator->create_mesh(create_mesh_desc(2));
+    EXPECT_EQ(first, second);
+    EXPECT_NE(first, other);
+    EXPECT_EQ(renderer.counters().meshes, 2);
+    EXPECT_EQ(creator->deduplicated_meshes(), 1);
+    EXPECT_EQ(creator->deduplicated_bytes(), content_bytes(desc));
+}
+
+TEST_F(ModelCreatorTest, CreateMesh_DoesNotShareMeshesWhoseHashesCollide)
+{
+    creator->deduplicate_meshes(true);
+
+    // The lookup hash mixes the size into the last, zero-padded word of a block, so these two
+    // meshes have the same lookup hash. Only the second hash tells them apart.
+    auto first  = creator->create_mesh(create_mesh_desc(1, {0, 1}));
+    auto second = creator->create_mesh(create_mesh_desc(1, {2, 1, 0}));
+    EXPECT_NE(first, second);
+    EXPECT_EQ(renderer.counters().meshes, 2);
+    EXPECT_EQ(creator->deduplicated_meshes(), 0);
+    EXPECT_EQ(creator->deduplicated_bytes(), 0);
+
+    // Both are still found
+    EXPECT_EQ(creator->create_mesh(create_mesh_desc(1, {2, 1, 0})), second);
+    EXPECT_EQ(creator->create_mesh(create_mesh_desc(1, {0, 1})), first);
+    EXPECT_EQ(renderer.counters().meshes, 2);
+    EXPECT_EQ(creator->deduplicated_meshes(), 2);
+}
+
+TEST_F(ModelCreatorTest, CreateMesh_CreatesReleasedMeshesAgain)
+{
+    creator->deduplicate_meshes(true);
+    const auto desc = create_mesh_desc(1);
+
+    auto first  = creator->create_mesh(desc);
+    auto second = creator->create_mesh(desc);
+    first.reset();
+    EXPECT_EQ(creator->create_mesh(desc), second);
+    EXPECT_EQ(renderer.counters().meshes, 1);
+
+    // Once no model uses the mesh, it is created anew
+    second.reset();
+    auto third = creator->create_mesh(desc);
+    EXPECT_NE(third, nullptr);
+    EXPECT_EQ(renderer.counters().meshes, 2);
+    EXPECT_EQ(creator->deduplicated_meshes(), 2);
+    EXPECT_EQ(creator->deduplicated_bytes(), 2 * content_bytes(desc));
+}
+
+TEST_F(ModelCreatorTest, CreateMesh_WithoutDeduplication_CreatesEveryMesh)
+{
+    const auto desc = create_mesh_desc(1);
+
+    auto first  = creator->create_mesh(desc);
+    auto second = creator->create_mesh(desc);
+    EXPECT_NE(first, second);
+    EXPECT_EQ(renderer.counters().meshes, 2);
+    EXPECT_EQ(creator->deduplicated_meshes(), 0);
+    EXPECT_EQ(creator->deduplicated_bytes(), 0);
+}
+
+TEST_F(ModelCreatorTest, CreateModel_SharedMeshesShareSortKeys)
+{
+    Model model;
+    model.meshes.push_back(create_model_mesh("Body", 0, 1));
+    model.meshes.push_back(create_model_mesh("Body", 1, 2));
+    model.meshes.push_back(create_model_mesh("Base", 0, 3));
+
+    const auto sort_keys = [](const RenderModel& render_model) {
+        std::vector<std::uint64_t> keys;
+        for (const auto& mesh : render_model.meshes()) {
+            keys.push_back(mesh.sort_key);
+        }
+        return keys;
+    };
+
+    // Without deduplication, every mesh has its own sort key
+    auto first  = creator->create_model(model);
+    auto second = creator->create_model(model);
+    for (const auto key : sort_keys(*first)) {
+        for (const auto other : sort_keys(*second)) {
+            EXPECT_NE(key, other);
+        }
+    }
+
+    // With deduplication, meshes with the same contents have the same sort key, including the
+    // meshes that are created later
+    creator->deduplicate_meshes(true);
+    auto shared = creator->create_model(model);
+    std::vector<ModelCreator::DeferredMesh> deferred;
+    auto                                    streamed = creator->create_model(model, deferred);
+    ASSERT_EQ(deferred.size(), 1);
+    EXPECT_EQ(streamed->meshes()[deferred[0].mesh].render_mesh, nullptr);
+
+    const auto& source = model.meshes[deferred[0].source];
+    creator->create_deferred_mesh(*streamed, deferred[0].mesh,
+                                  ModelCreator::create_mesh_desc(source.materials[0]));
+    EXPECT_EQ(sort_keys(*streamed), sort_keys(*shared));
+    for (std::size_t i = 0; i < shared->meshes().size(); ++i) {
+        EXPECT_EQ(streamed->meshes()[i].render_mesh, shared->meshes()[i].render_mesh);
+    }
+}
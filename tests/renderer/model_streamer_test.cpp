@@ -0,0 +1,241 @@
+#include <benchmarks/null_renderer.hpp>
+#include <gtest/gtest.h>
+#include <openglyph/io/mapped_file.hpp>
+#include <openglyph/renderer/model_creator.hpp>
+#include <openglyph/renderer/model_streamer.hpp>
+
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using openglyph::benchmarks::NullRenderer;
+using openglyph::renderer::ModelCreator;
+using openglyph::renderer::ModelStreamer;
+using openglyph::renderer::RenderModel;
+
+namespace {
+// Appends the bytes of a value
+template <typename T>
+void append(std::vector<std::uint8_t>& data, const T& value)
+{
+    const auto* bytes = reinterpret_cast<const std::uint8_t*>(&value);
+    data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+// Writes models in the ALO format, with only the chunks that the model reader uses
+class ModelWriter
+{
+public:
+    // Adds a visible mesh with one material and the given number of triangles
+    void add_mesh(const std::string& name, std::uint32_t num_triangles)
+    {
+        begin_chunk(0x400);
+        write_chunk(0x401, name.c_str(), name.size() + 1);
+        // Material count, bounding box, an unused value and whether the mesh is hidden
+        std::vector<std::uint8_t> mesh_info;
+        append(mesh_info, std::uint32_t{1});
+        for (const float value : {0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f}) {
+            append(mesh_info, value);
+        }
+        append(mesh_info, std::uint32_t{0});
+        append(mesh_info, std::uint32_t{0});
+        write_chunk(0x402, mesh_info.data(), mesh_info.size());
+
+        begin_chunk(0x10100);
+        write_chunk(0x10101, "Mesh.fx", 8);
+        end_chunk();
+
+        // Every triangle has its own vertices; a vertex is 32 values, starting with its position
+        begin_chunk(0x10000);
+        const std::uint32_t submesh_info[] = {num_triangles * 3, num_triangles};
+        write_chunk(0x10001, submesh_info, sizeof(submesh_info));
+        std::vector<float>         vertices(num_triangles * 3 * 32, 0.0f);
+        std::vector<std::uint16_t> indices(num_triangles * 3);
+        for (std::size_t i = 0; i < indices.size(); ++i) {
+            vertices[i * 32 + 0] = static_cast<float>(i % 3 == 1);
+            vertices[i * 32 + 1] = static_cast<float>(i % 3 == 2);
+            indices[i]           = static_cast<std::uint16_t>(i);
+        }
+        write_chunk(0x10005, vertices.data(), vertices.size() * sizeof(float));
+        write_chunk(0x10004, indices.data(), indices.size() * sizeof(std::uint16_t));
+        end_chunk();
+
+        end_chunk();
+    }
+
+    std::vector<std::uint8_t> data;
+
+private:
+    // Writes a chunk with data
+    void write_chunk(std::uint32_t id, const void* bytes, std::size_t size)
+    {
+        const auto* begin = static_cast<const std::uint8_t*>(bytes);
+        append(data, id);
+        append(data, static_cast<std::uint32_t>(size));
+        data.insert(data.end(), begin, begin + size);
+    }
+
+    // Starts a chunk with child chunks; its size is written when it ends
+    void begin_chunk(std::uint32_t id)
+    {
+        append(data, id);
+        m_chunks.push_back(data.size());
+        append(data, std::uint32_t{0});
+    }
+
+    void end_chunk()
+    {
+        const auto start = m_chunks.back() + sizeof(std::uint32_t);
+        const auto size  = static_cast<std::uint32_t>(data.size() - start) | 0x80000000u;
+        std::memcpy(&data[m_chunks.back()], &size, sizeof(size));
+        m_chunks.pop_back();
+    }
+
+    std::vector<std::size_t> m_chunks;
+};
+
+class ModelStreamerTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        // A mesh with three LoD levels, with more triangles per level, and a mesh without LoDs
+        ModelWriter lods;
+        lods.add_mesh("Body_LOD0", 1);
+        lods.add_mesh("Body_LOD1", 2);
+        lods.add_mesh("Body_LOD2", 3);
+        lods.add_mesh("Base", 1);
+        models["Lods"] = std::move(lods.data);
+
+        ModelWriter plain;
+        plain.add_mesh("Body", 2);
+        models["Plain"] = std::move(plain.data);
+
+        material = renderer.create_material({});
+        creator  = std::make_unique<ModelCreator>(
+            renderer, [this](openglyph::Symbol) { return material.get(); },
+            [](std::string_view) -> khepri::renderer::Texture* { return nullptr; });
+    }
+
+    std::unique_ptr<ModelStreamer> create_streamer()
+    {
+        return std::make_unique<ModelStreamer>(
+            *creator,
+            [this](std::string_view name) -> std::unique_ptr<khepri::io::Stream> {
+                const auto it = models.find(std::string(name));
+                if (it == models.end()) {
+                    return {};
+                }
+                return std::make_unique<openglyph::io::MemoryStream>(it->second);
+            },
+            ModelStreamer::Options{});
+    }
+
+    // Returns the number of meshes of a model that have a renderable mesh
+    static std::size_t resident_count(const RenderModel& model)
+    {
+        std::size_t count = 0;
+        for (const auto& mesh : model.meshes()) {
+            count += (mesh.render_mesh != nullptr) ? 1 : 0;
+        }
+        return count;
+    }
+
+    // Returns the mesh that a LoD group draws at full detail
+    static const RenderModel::Mesh& drawn_mesh(const RenderModel& model, std::size_t group)
+    {
+        return model.meshes()[model.lod_groups()[group].select(0)];
+    }
+
+    NullRenderer                                     renderer;
+    std::unique_ptr<khepri::renderer::Material>      material;
+    std::unique_ptr<ModelCreator>                    creator;
+    std::map<std::string, std::vector<std::uint8_t>> models;
+};
+} // namespace
+
+TEST_F(ModelStreamerTest, Load_ReturnsDrawableModelWithLeastDetailedMeshes)
+{
+    auto streamer = create_streamer();
+    auto model    = streamer->load("Lods");
+    ASSERT_NE(model, nullptr);
+    ASSERT_EQ(model->meshes().size(), 4);
+    ASSERT_EQ(model->lod_groups().size(), 2);
+
+    // Only the least detailed variant and the mesh without LoDs are created
+    EXPECT_EQ(renderer.counters().meshes, 2);
+    EXPECT_EQ(resident_count(*model), 2);
+    EXPECT_EQ(streamer->streaming_count(), 1);
+
+    // Every group draws a resident mesh right away
+    for (std::size_t group = 0; group < model->lod_groups().size(); ++group) {
+        EXPECT_NE(drawn_mesh(*model, group).render_mesh, nullptr);
+    }
+    EXPECT_EQ(drawn_mesh(*model, 0).lod, 0);
+
+    EXPECT_EQ(streamer->load("Unknown"), nullptr);
+}
+
+TEST_F(ModelStreamerTest, Update_MakesLevelsResidentInOrderAndCompletesOccluder)
+{
+    auto streamer = create_streamer();
+    auto model    = streamer->load("Lods");
+
+    // Until the most detailed mesh is resident, the occluder only has the mesh without LoDs
+    EXPECT_EQ(model->occluder().indices.size(), 3);
+
+    // Without a thread pool, a level is decoded when it is started and created on the next update
+    for (unsigned int lod = 1; lod <= 2; ++lod) {
+        const auto generation = streamer->generation();
+        streamer->update();
+        streamer->update();
+        EXPECT_NE(streamer->generation(), generation);
+        EXPECT_EQ(drawn_mesh(*model, 0).lod, lod);
+        EXPECT_NE(drawn_mesh(*model, 0).render_mesh, nullptr);
+        EXPECT_EQ(model->occluder().indices.size(), lod == 2 ? 3 + 9 : 3);
+    }
+    EXPECT_EQ(resident_count(*model), 4);
+    EXPECT_EQ(renderer.counters().meshes, 4);
+    EXPECT_EQ(streamer->streaming_count(), 0);
+
+    // Nothing changes after the model is complete
+    const auto generation = streamer->generation();
+    streamer->update();
+    EXPECT_EQ(streamer->generation(), generation);
+}
+
+TEST_F(ModelStreamerTest, Cancel_KeepsDeferredMeshesUnresident)
+{
+    auto streamer = create_streamer();
+    auto model    = streamer->load("Lods");
+
+    // Cancel while the first level is pending; it is dropped when it completes
+    streamer->update();
+    streamer->cancel(*model);
+    model.reset();
+    streamer->update();
+    streamer->update();
+    EXPECT_EQ(renderer.counters().meshes, 2);
+    EXPECT_EQ(streamer->streaming_count(), 0);
+
+    // Canceling a model that is not streamed does nothing
+    auto other = streamer->load("Lods");
+    streamer->update();
+    streamer->update();
+    auto plain = streamer->load("Plain");
+    streamer->cancel(*plain);
+    EXPECT_EQ(streamer->streaming_count(), 1);
+    EXPECT_EQ(resident_count(*other), 3);
+}
+
+TEST_F(ModelStreamerTest, Load_ReturnsModelsWithoutLodsComplete)
+{
+    auto streamer = create_streamer();
+    auto model    = streamer->load("Plain");
+    ASSERT_NE(model, nullptr);
+    EXPECT_EQ(resident_count(*model), 1);
+    EXPECT_EQ(streamer->streaming_count(), 0);
+    EXPECT_EQ(model->occluder().indices.size(), 6);
+}
@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include <openglyph/renderer/occlusion_buffer.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+using openglyph::renderer::BoundingBox;
+using openglyph::renderer::OcclusionBuffer;
+
+namespace {
+constexpr unsigned int WIDTH  = 64;
+constexpr unsigned int HEIGHT = 32;
+
+const khepri::Matrixf IDENTITY{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+
+// A projection for row vectors with a 90 degree field of view, looking down -z. Clip-space w is
+// the distance in front of the camera.
+const khepri::Matrixf PERSPECTIVE{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, -1, -1, 0, 0, -0.2f, 0};
+
+// Returns the point at a screen position (in pixels) and distance in front of the camera
+khepri::Vector3f at_screen(float x, float y, float depth)
+{
+    return {(x / WIDTH - 0.5f) * 2 * depth, (0.5f - y / HEIGHT) * 2 * depth, -depth};
+}
+
+// Returns a box around a point in front of the camera
+BoundingBox box_at(float x, float y, float depth, float size)
+{
+    return {{x - size, y - size, -depth - size}, {x + size, y + size, -depth + size}};
+}
+
+// A square wall across the view at a distance
+struct Wall
+{
+    std::vector<khepri::Vector3f> vertices;
+    std::vector<std::uint32_t>    indices{0, 1, 2, 0, 2, 3};
+
+    Wall(float depth, float size)
+        : vertices{{-size, -size, -depth}, {size, -size, -depth}, {size, size, -depth},
+                   {-size, size, -depth}}
+    {}
+};
+} // namespace
+
+TEST(OcclusionBufferTest, Constructor_RoundsWidthUp)
+{
+    const OcclusionBuffer buffer(61, HEIGHT);
+    EXPECT_EQ(buffer.width(), 64U);
+    EXPECT_EQ(buffer.height(), HEIGHT);
+    EXPECT_EQ(buffer.depths().size(), std::size_t{64} * HEIGHT);
+}
+
+TEST(OcclusionBufferTest, Constructor_ZeroSize_Throws)
+{
+    EXPECT_THROW(OcclusionBuffer(0, HEIGHT), std::invalid_argument);
+    EXPECT_THROW(OcclusionBuffer(WIDTH, 0), std::invalid_argument);
+}
+
+TEST(OcclusionBufferTest, Clear_ResetsDepths)
+{
+    OcclusionBuffer buffer(WIDTH, HEIGHT);
+    buffer.clear(PERSPECTIVE);
+    const Wall wall(10, 100);
+    buffer.add_occluder(wall.vertices, wall.indices, IDENTITY);
+    buffer.clear(PERSPECTIVE);
+    for (const auto depth : buffer.depths()) {
+        EXPECT_EQ(depth, std::numeric_limits<float>::infinity());
+    }
+}
+
+TEST(OcclusionBufferTest, Wall_HidesObjectsBehindIt)
+{
+    OcclusionBuffer buffer(WIDTH, HEIGHT);
+    buffer.clear(PERSPECTIVE);
+    const Wall wall(10, 100);
+    buffer.add_occluder(wall.vertices, wall.indices, IDENTITY);
+
+    EXPECT_FALSE(buffer.is_visible(box_at(0, 0, 50, 1), IDENTITY));
+    EXPECT_TRUE(buffer.is_visible(box_at(0, 0, 5, 1), IDENTITY));
+    // Boxes that intersect the wall, or cross the near plane, are visible
+    EXPECT_TRUE(buffer.is_visible(box_at(0, 0, 10, 1), IDENTITY));
+    EXPECT_TRUE(buffer.is_visible(box_at(0, 0, 0, 1), IDENTITY));
+}
+
+TEST(OcclusionBufferTest, SmallOccluder_HidesOnlyWhatItCovers)
+{
+    OcclusionBuffer buffer(WIDTH, HEIGHT);
+    buffer.clear(PERSPECTIVE);
+    const Wall wall(10, 2);
+    buffer.add_occluder(wall.vertices, wall.indices, IDENTITY);
+
+    EXPECT_FALSE(buffer.is_visible(box_at(0, 0, 50, 1), IDENTITY));
+    EXPECT_TRUE(buffer.is_visible(box_at(0, 0, 50, 20), IDENTITY));
+    EXPECT_TRUE(buffer.is_visible(box_at(30, 0, 50, 1), IDENTITY));
+}
+
+TEST(OcclusionBufferTest, Transform_MovesOccluder)
+{
+    OcclusionBuffer buffer(WIDTH, HEIGHT);
+    buffer.clear(PERSPECTIVE);
+    const Wall wall(10, 2);
+    // Moves the wall 40 units to the right, to x = 4 at depth 10
+    const khepri::Matrixf translation{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 4, 0, 0, 1};
+    buffer.add_occluder(wall.vertices, wall.indices, translation);
+
+    EXPECT_TRUE(buffer.is_visible(box_at(0, 0, 50, 1), IDENTITY));
+    EXPECT_FALSE(buffer.is_visible(box_at(20, 0, 50, 1), IDENTITY));
+}
+
+TEST(OcclusionBufferTest, NearPlaneCrossingOccluder_IsSkipped)
+{
+    OcclusionBuffer buffer(WIDTH, HEIGHT);
+    buffer.clear(PERSPECTIVE);
+    const std::vector<khepri::Vector3f> vertices{{-10, -10, 5}, {10, -10, -20}, {0, 10, -20}};
+    const std::vector<std::uint32_t>    indices{0, 1, 2};
+    buffer.add_occluder(vertices, indices, IDENTITY);
+    for (const auto depth : buffer.depths()) {
+        EXPECT_EQ(depth, std::numeric_limits<float>::infinity());
+    }
+}
+
+TEST(OcclusionBufferTest, Rasterize_CoversPixelCentersInsideTriangle)
+{
+    // Compare the rasterized pixels, four at a time with SSE, against a per-pixel reference
+    constexpr float                           depth = 2;
+    const std::array<std::array<float, 2>, 3> screen{
+        {{5.3f, 3.1f}, {50.7f, 12.2f}, {20.2f, 29.8f}}};
+    for (const bool reversed : {false, true}) {
+        OcclusionBuffer buffer(WIDTH, HEIGHT);
+        buffer.clear(PERSPECTIVE);
+        std::vector<khepri::Vector3f> vertices;
+        for (const auto& p : screen) {
+            vertices.push_back(at_screen(p[0], p[1], depth));
+        }
+        const std::vector<std::uint32_t> indices =
+            reversed ? std::vector<std::uint32_t>{0, 2, 1} : std::vector<std::uint32_t>{0, 1, 2};
+        buffer.add_occluder(vertices, indices, IDENTITY);
+
+        const auto depths = buffer.depths();
+        for (unsigned int y = 0; y < HEIGHT; ++y) {
+            for (unsigned int x = 0; x < WIDTH; ++x) {
+                // A pixel is covered if its center is on the same side of every edge
+                const float px       = x + 0.5f;
+                const float py       = y + 0.5f;
+                int         positive = 0;
+                int         negative = 0;
+                bool        edge     = false;
+                for (std::size_t i = 0; i < 3; ++i) {
+                    const auto& from = screen[i];
+                    const auto& to   = screen[(i + 1) % 3];
+                    const float e    = (from[1] - to[1]) * px + (to[0] - from[0]) * py +
+                                       (from[0] * to[1] - to[0] * from[1]);
+                    positive += e > 0 ? 1 : 0;
+                    negative += e < 0 ? 1 : 0;
+                    if (std::abs(e) < 1e-2f) {
+                        edge = true;
+                    }
+                }
+                if (edge) {
+                    continue;
+                }
+                const bool  covered = positive == 3 || negative == 3;
+                const float actual  = depths[std::size_t{y} * WIDTH + x];
+                EXPECT_EQ(actual < std::numeric_limits<float>::infinity(), covered)
+                    << "pixel " << x << ", " << y;
+                if (covered) {
+                    EXPECT_NEAR(actual, depth, 1e-4f) << "pixel " << x << ", " << y;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+#include <openglyph/renderer/vertex_compression.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+using openglyph::renderer::compress_vertices;
+using openglyph::renderer::decompress_vertices;
+using openglyph::renderer::Model;
+
+namespace {
+khepri::Vector3f cross(const khepri::Vector3f& a, const khepri::Vector3f& b)
+{
+    return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+khepri::Vector3f normalize(const khepri::Vector3f& v)
+{
+    const float length = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+    return {v.x / length, v.y / length, v.z / length};
+}
+
+// Returns vertices with random unit normals, tangents perpendicular to them, and binormals
+// of either orientation
+std::vector<Model::Vertex> random_vertices(std::size_t count, std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> uv(-4.0f, 4.0f);
+    std::uniform_real_distribution<float> color(-0.25f, 1.25f);
+
+    const auto vector = [&] { return khepri::Vector3f{value(rng), value(rng), value(rng)}; };
+
+    std::vector<Model::Vertex> vertices(count);
+    for (auto& vertex : vertices) {
+        vertex.position = {value(rng) * 100, value(rng) * 100, value(rng) * 100};
+        vertex.normal   = normalize(vector());
+        vertex.tangent  = normalize(cross(vertex.normal, vector()));
+        vertex.binormal = cross(vertex.normal, vertex.tangent);
+        if (value(rng) < 0) {
+            vertex.binormal = {-vertex.binormal.x, -vertex.binormal.y, -vertex.binormal.z};
+        }
+        for (auto& coordinates : vertex.uv) {
+            coordinates = {uv(rng), uv(rng)};
+        }
+        vertex.color = {color(rng), color(rng), color(rng), color(rng)};
+    }
+    return vertices;
+}
+
+void expect_near(const khepri::Vector3f& actual, const khepri::Vector3f& expected, float error)
+{
+    EXPECT_NEAR(actual.x, expected.x, error);
+    EXPECT_NEAR(actual.y, expected.y, error);
+    EXPECT_NEAR(actual.z, expected.z, error);
+}
+} // namespace
+
+TEST(VertexCompressionTest, RoundTrip_PreservesVertices)
+{
+    // 11 vertices: two groups of four, plus a remainder
+    std::mt19937 rng(42);
+    const auto   vertices = random_vertices(11, rng);
+
+    std::vector<Model::CompactVertex> compact(vertices.size());
+    std::vector<Model::Vertex>        result(vertices.size());
+    compress_vertices(vertices, compact);
+    decompress_vertices(compact, result);
+
+    for (std::size_t i = 0; i < vertices.size(); ++i) {
+        SCOPED_TRACE(i);
+        const auto& expected = vertices[i];
+        const auto& actual   = result[i];
+        expect_near(actual.position, expected.position, 0);
+        expect_near(actual.normal, expected.normal, 1e-3f);
+        expect_near(actual.tangent, expected.tangent, 1e-3f);
+        expect_near(actual.binormal, expected.binormal, 2e-3f);
+        for (std::size_t j = 0; j < 4; ++j) {
+            // Half precision has 11 significant bits
+            EXPECT_NEAR(actual.uv[j].x, expected.uv[j].x, std::abs(expected.uv[j].x) / 2048);
+            EXPECT_NEAR(actual.uv[j].y, expected.uv[j].y, std::abs(expected.uv[j].y) / 2048);
+        }
+        const auto clamped = [](float value) { return std::min(std::max(value, 0.0f), 1.0f); };
+        EXPECT_NEAR(actual.color.r, clamped(expected.color.r), 0.5f / 255);
+        EXPECT_NEAR(actual.color.g, clamped(expected.color.g), 0.5f / 255);
+        EXPECT_NEAR(actual.color.b, clamped(expected.color.b), 0.5f / 255);
+        EXPECT_NEAR(actual.color.a, clamped(expected.color.a), 0.5f / 255);
+    }
+}
+
+TEST(VertexCompressionTest, HalfPrecision_HandlesSpecialValues)
+{
+    const float         inf         = std::numeric_limits<float>::infinity();
+    const float         values[8]   = {1.0f, -2.5f, 65504.0f, 70000.0f, -inf, 1e-6f, 0.0f, -0.0f};
+    const std::uint16_t expected[8] = {0x3c00, 0xc100, 0x7bff, 0x7c00, 0xfc00, 0x0011, 0, 0x8000};
+
+    Model::Vertex vertex{};
+    for (std::size_t j = 0; j < 4; ++j) {
+        vertex.uv[j] = {values[j * 2], values[j * 2 + 1]};
+    }
+    const std::vector<Model::Vertex>  vertices(4, vertex);
+    std::vector<Model::CompactVertex> compact(vertices.size());
+    compress_vertices(vertices, compact);
+
+    std::vector<Model::Vertex> result(vertices.size());
+    decompress_vertices(compact, result);
+    for (std::size_t i = 0; i < compact.size(); ++i) {
+        for (std::size_t j = 0; j < 8; ++j) {
+            EXPECT_EQ(compact[i].uv[j / 2][j % 2], expected[j]) << "vertex " << i << ", " << j;
+        }
+        EXPECT_EQ(result[i].uv[1].x, 65504.0f);
+        EXPECT_EQ(result[i].uv[1].y, inf);
+        EXPECT_EQ(result[i].uv[2].x, -inf);
+        EXPECT_TRUE(std::signbit(result[i].uv[3].y));
+    }
+}
+
+TEST(VertexCompressionTest, Batch_MatchesSingleVertices)
+{
+    // Batches are converted four vertices at a time with SSE where available; single vertices
+    // always use the scalar conversion. Both must give identical results.
+    std::mt19937 rng(7);
+    auto         vertices = random_vertices(64, rng);
+    vertices[0].uv[0]     = {std::numeric_limits<float>::quiet_NaN(), 1e-7f};
+    vertices[1].normal    = {0, 0, -1};
+    vertices[2].tangent   = {0, 0, 0};
+
+    std::vector<Model::CompactVertex> batch(vertices.size());
+    compress_vertices(vertices, batch);
+    std::vector<Model::CompactVertex> single(vertices.size());
+    for (std::size_t i = 0; i < vertices.size(); ++i) {
+        compress_vertices({&vertices[i], 1}, {&single[i], 1});
+        EXPECT_EQ(std::memcmp(&batch[i], &single[i], sizeof(Model::CompactVertex)), 0)
+            << "compressing vertex " << i;
+    }
+
+    std::vector<Model::Vertex> batch_result(vertices.size());
+    decompress_vertices(batch, batch_result);
+    for (std::size_t i = 0; i < vertices.size(); ++i) {
+        Model::Vertex single_result{};
+        decompress_vertices({&batch[i], 1}, {&single_result, 1});
+        EXPECT_EQ(std::memcmp(&batch_result[i], &single_result, sizeof(Model::Vertex)), 0)
+            << "decompressing vertex " << i;
+    }
+}
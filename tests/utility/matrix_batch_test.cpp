@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include <openglyph/utility/matrix_batch.hpp>
+
+#include <array>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using openglyph::multiply_batch;
+
+namespace {
+std::vector<khepri::Matrixf> random_matrices(std::size_t count, std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> value(-10.0f, 10.0f);
+    std::vector<khepri::Matrixf>          matrices;
+    for (std::size_t i = 0; i < count; ++i) {
+        matrices.emplace_back(value(rng), value(rng), value(rng), value(rng), value(rng),
+                              value(rng), value(rng), value(rng), value(rng), value(rng),
+                              value(rng), value(rng), value(rng), value(rng), value(rng),
+                              value(rng));
+    }
+    return matrices;
+}
+
+std::array<float, 16> elements(const khepri::Matrixf& matrix)
+{
+    std::array<float, 16> result{};
+    std::memcpy(result.data(), &matrix, sizeof(result));
+    return result;
+}
+} // namespace
+
+TEST(MatrixBatchTest, MatchesMatrixProduct)
+{
+    // 11 matrices: two groups of four, plus a remainder
+    std::mt19937 rng(42);
+    const auto   lhs = random_matrices(11, rng);
+    const auto   rhs = random_matrices(11, rng);
+
+    std::vector<khepri::Matrixf> result(lhs.size());
+    multiply_batch(lhs, rhs, result);
+
+    for (std::size_t i = 0; i < lhs.size(); ++i) {
+        const auto expected = elements(lhs[i] * rhs[i]);
+        const auto actual   = elements(result[i]);
+        for (std::size_t j = 0; j < 16; ++j) {
+            EXPECT_NEAR(actual[j], expected[j], 1e-3f) << "matrix " << i << ", element " << j;
+        }
+    }
+}
+
+TEST(MatrixBatchTest, EmptyInput_DoesNothing)
+{
+    const std::vector<khepri::Matrixf> empty;
+    std::vector<khepri::Matrixf>       result;
+    EXPECT_NO_THROW(multiply_batch(empty, empty, result));
+}
+
+TEST(MatrixBatchTest, SizeMismatch_Throws)
+{
+    std::mt19937                 rng(42);
+    const auto                   lhs = random_matrices(4, rng);
+    const auto                   rhs = random_matrices(3, rng);
+    std::vector<khepri::Matrixf> result(4);
+    EXPECT_THROW(multiply_batch(lhs, rhs, result), std::invalid_argument);
+}
@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include <openglyph/utility/radix_sort.hpp>
+
+#include <algorithm>
+#include <random>
+
+using openglyph::radix_sort;
+
+namespace {
+using Items = std::vector<std::pair<std::uint64_t, int>>;
+}
+
+TEST(RadixSortTest, EmptyInput_RemainsEmpty)
+{
+    Items items;
+    Items scratch;
+    radix_sort(items, scratch);
+    EXPECT_TRUE(items.empty());
+}
+
+TEST(RadixSortTest, RandomKeys_MatchesStableSort)
+{
+    std::mt19937_64 rng(42);
+    Items           items;
+    for (int i = 0; i < 10000; ++i) {
+        items.emplace_back(rng(), i);
+    }
+
+    auto expected = items;
+    std::stable_sort(expected.begin(), expected.end(),
+                     [](const auto& i1, const auto& i2) { return i1.first < i2.first; });
+
+    Items scratch;
+    radix_sort(items, scratch);
+    EXPECT_EQ(items, expected);
+}
+
+TEST(RadixSortTest, DuplicateKeys_KeepsInputOrder)
+{
+    // Few distinct keys, spread over several digits, so most passes are skipped
+    std::mt19937 rng(42);
+    Items        items;
+    for (int i = 0; i < 1000; ++i) {
+        items.emplace_back(std::uint64_t{rng() % 4} << 40, i);
+    }
+
+    auto expected = items;
+    std::stable_sort(expected.begin(), expected.end(),
+                     [](const auto& i1, const auto& i2) { return i1.first < i2.first; });
+
+    Items scratch;
+    radix_sort(items, scratch);
+    EXPECT_EQ(items, expected);
+}
+
+TEST(RadixSortTest, IdenticalKeys_KeepsInputOrder)
+{
+    Items items;
+    for (int i = 0; i < 100; ++i) {
+        items.emplace_back(0x0123456789abcdefull, i);
+    }
+    const auto expected = items;
+
+    Items scratch;
+    radix_sort(items, scratch);
+    EXPECT_EQ(items, expected);
+}
@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include <openglyph/utility/symbol.hpp>
+
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+using openglyph::Symbol;
+
+TEST(SymbolTest, Empty_HasIdZero)
+{
+    EXPECT_TRUE(Symbol().empty());
+    EXPECT_EQ(Symbol().id(), 0);
+    EXPECT_EQ(Symbol(""), Symbol());
+    EXPECT_TRUE(Symbol().str().empty());
+}
+
+TEST(SymbolTest, Intern_FoldsCase)
+{
+    const Symbol symbol("SymbolTest_Folded");
+    EXPECT_FALSE(symbol.empty());
+    EXPECT_EQ(Symbol("symboltest_folded"), symbol);
+    EXPECT_EQ(Symbol("SYMBOLTEST_FOLDED"), symbol);
+    EXPECT_EQ(Symbol("symbolTEST_folded").hash(), symbol.hash());
+    EXPECT_EQ(std::hash<Symbol>{}(Symbol("SymbolTest_FOLDED")), std::hash<Symbol>{}(symbol));
+
+    // The spelling is the one of the first intern
+    EXPECT_EQ(Symbol("SYMBOLTEST_FOLDED").str(), "SymbolTest_Folded");
+
+    EXPECT_NE(Symbol("SymbolTest_Folded2"), symbol);
+}
+
+TEST(SymbolTest, Find_DoesNotIntern)
+{
+    EXPECT_FALSE(Symbol::find("SymbolTest_Unknown").has_value());
+    EXPECT_FALSE(Symbol::find("SymbolTest_Unknown").has_value());
+
+    const Symbol symbol("SymbolTest_Known");
+    const auto   found = Symbol::find("SYMBOLTEST_KNOWN");
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ(*found, symbol);
+}
+
+TEST(SymbolTest, Str_OutlivesInternedString)
+{
+    Symbol symbol;
+    {
+        std::string str(1000, 'x');
+        str += "_SymbolTest_Long";
+        symbol = Symbol(str);
+    }
+    EXPECT_EQ(symbol.str().size(), 1016);
+    EXPECT_EQ(symbol.str().substr(1000), "_SymbolTest_Long");
+}
+
+TEST(SymbolTest, Intern_ConcurrentlyYieldsOneIdPerName)
+{
+    constexpr int THREAD_COUNT = 8;
+    constexpr int NAME_COUNT   = 2000;
+
+    // Every thread interns the same names, in different cases and orders
+    std::vector<std::vector<Symbol>> symbols(THREAD_COUNT, std::vector<Symbol>(NAME_COUNT));
+    std::vector<std::thread>         threads;
+    for (int t = 0; t < THREAD_COUNT; ++t) {
+        threads.emplace_back([&symbols, t] {
+            for (int i = 0; i < NAME_COUNT; ++i) {
+                const auto  n    = (t % 2 == 0) ? i : NAME_COUNT - 1 - i;
+                std::string name = "SymbolTest_Concurrent_" + std::to_string(n);
+                if (t % 3 == 0) {
+                    name[0] = 's';
+                }
+                symbols[t][n] = Symbol(name);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::unordered_set<Symbol::Id> ids;
+    for (int i = 0; i < NAME_COUNT; ++i) {
+        for (int t = 1; t < THREAD_COUNT; ++t) {
+            EXPECT_EQ(symbols[t][i], symbols[0][i]);
+        }
+        ids.insert(symbols[0][i].id());
+        // Only the case of the first letter differs between threads
+        EXPECT_EQ(symbols[0][i].str().substr(1), "ymbolTest_Concurrent_" + std::to_string(i));
+    }
+    EXPECT_EQ(ids.size(), NAME_COUNT);
+}
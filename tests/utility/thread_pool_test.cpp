@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <openglyph/utility/thread_pool.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using openglyph::ThreadPool;
+
+TEST(ThreadPoolTest, ParallelFor_RunsEveryTask)
+{
+    ThreadPool                    pool(4);
+    std::vector<std::atomic<int>> counts(1000);
+    pool.parallel_for(counts.size(), [&](std::size_t index) { ++counts[index]; });
+    for (const auto& count : counts) {
+        EXPECT_EQ(count.load(), 1);
+    }
+}
+
+TEST(ThreadPoolTest, ParallelFor_NestedAndConcurrentJobs)
+{
+    ThreadPool       pool(4);
+    std::atomic<int> sum{0};
+    const auto       run = [&] {
+        for (int i = 0; i < 100; ++i) {
+            pool.parallel_for(10, [&](std::size_t) {
+                pool.parallel_for(3, [&](std::size_t) { ++sum; });
+            });
+        }
+    };
+    std::thread other(run);
+    run();
+    other.join();
+    EXPECT_EQ(sum.load(), 2 * 100 * 10 * 3);
+}
+
+TEST(ThreadPoolTest, ParallelFor_RethrowsException)
+{
+    ThreadPool       pool(4);
+    std::atomic<int> count{0};
+    EXPECT_THROW(pool.parallel_for(100,
+                                   [&](std::size_t index) {
+                                       ++count;
+                                       if (index == 50) {
+                                           throw std::runtime_error("task failed");
+                                       }
+                                   }),
+                 std::runtime_error);
+    EXPECT_EQ(count.load(), 100);
+}
+
+TEST(ThreadPoolTest, Async_ReturnsResult)
+{
+    ThreadPool pool(4);
+    auto       result = pool.async([] { return 42; });
+    auto       failed = pool.async([]() -> int { throw std::runtime_error("task failed"); });
+    EXPECT_EQ(result.get(), 42);
+    EXPECT_THROW(failed.get(), std::runtime_error);
+}
+
+TEST(ThreadPoolTest, Async_RunsAlongsideJobs)
+{
+    // A background task that waits for a job to finish must not keep the job from running
+    ThreadPool         pool(2);
+    std::promise<void> job_done;
+    auto               background = pool.async([done = job_done.get_future()] { done.wait(); });
+    std::atomic<int>   count{0};
+    pool.parallel_for(100, [&](std::size_t) { ++count; });
+    job_done.set_value();
+    background.get();
+    EXPECT_EQ(count.load(), 100);
+}
+
+TEST(ThreadPoolTest, Async_WithoutWorkers_RunsImmediately)
+{
+    ThreadPool pool(1);
+    const auto caller = std::this_thread::get_id();
+    auto       result = pool.async([] { return std::this_thread::get_id(); });
+    ASSERT_EQ(result.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+    EXPECT_EQ(result.get(), caller);
+}